@@ -1,10 +1,117 @@
 #ifndef AI_H
 #define AI_H
 
+#include <stdatomic.h>
 #include <stdbool.h>
+#include <stddef.h>
 #include "game_logic.h"
 
-void ai_init(void);
-bool ai_pick_move(const GameState *state, Move *outMove);
+#define AI_DEFAULT_TIME_MS 100
+#define AI_MAX_DEPTH 64
+#define AI_MAX_THREADS 64
+
+typedef enum {
+    AI_ENGINE_ALPHA_BETA = 0,
+    AI_ENGINE_MCTS
+} AiEngine;
+
+typedef struct {
+    AiEngine engine;           /* alpha-beta (default) or Monte Carlo tree search */
+    size_t hashSizeMb;         /* transposition table size; 0 disables it */
+    int threads;               /* search threads per move, 1..AI_MAX_THREADS */
+    const char *solutionPath;  /* optional table from tools/solver; NULL = none */
+    const char *tablebasePath; /* optional endgame table from tools/tbgen; NULL = none */
+    bool orderMoves;           /* killer/history move ordering; off only for comparisons */
+} AiConfig;
+
+/*
+ * Perfect only plays perfectly with a solution table (AiConfig.solutionPath)
+ * that covers the game: solved positions are answered from it without any
+ * search. Elsewhere it searches like hard with a longer budget, scoring any
+ * position found in either table exactly.
+ */
+typedef enum {
+    AI_DIFFICULTY_EASY = 0,
+    AI_DIFFICULTY_MEDIUM,
+    AI_DIFFICULTY_HARD,
+    AI_DIFFICULTY_PERFECT
+} AiDifficulty;
+
+/*
+ * Progress of an alpha-beta search, reported after each iteration the
+ * main search thread finishes and never after ai_pick_move has returned. The score is in hundredths of a capture from the
+ * side to move's point of view; beyond +-AI_DECIDED_SCORE the result of the
+ * game is already decided. The principal variation follows the hash moves
+ * from the root and may end early where entries were overwritten.
+ */
+#define AI_DECIDED_SCORE 99000
+
+typedef struct {
+    int depth;
+    int score;
+    unsigned long nodes;
+    unsigned long long elapsedUs;
+    Move pv[AI_MAX_DEPTH];
+    size_t pvLength;
+} AiSearchInfo;
+
+typedef void (*AiInfoCallback)(const AiSearchInfo *info, void *userData);
+
+/*
+ * Per-move search limits. The search runs on its own threads while the
+ * caller sleeps until hardTimeMs less a margin learned from past delays,
+ * then replies with the best move found so far without waiting for the
+ * searchers. That keeps replies inside hardTimeMs on a loaded machine in
+ * all but rare cases; the limit is best-effort, since the OS can still
+ * leave the woken caller waiting for a CPU. The soft limit only stops a
+ * new iteration from starting. MCTS ignores maxDepth and softTimeMs and
+ * counts playouts against maxNodes.
+ */
+typedef struct {
+    int maxDepth;              /* iterative deepening stops here; 0 = AI_MAX_DEPTH */
+    unsigned long maxNodes;
+    unsigned int softTimeMs;   /* no new iteration starts after this */
+    unsigned int hardTimeMs;   /* the search is abandoned at this point */
+    const atomic_bool *stop;   /* optional; the search gives up once it is set */
+    AiInfoCallback onInfo;     /* optional; called on the main search thread */
+    void *infoUserData;
+} AiSearchLimits;
+
+/* What the last ai_pick_move did; MCTS reports playouts as nodes and no depth. */
+typedef struct {
+    unsigned long nodes;
+    int depth;
+} AiSearchStats;
+
+void ai_default_config(AiConfig *config);
+/*
+ * Passing NULL uses ai_default_config. Returns false if the hash table could
+ * not be allocated or a solution table or tablebase could not be opened;
+ * the AI still works without any of them.
+ */
+bool ai_init(const AiConfig *config);
+void ai_shutdown(void);
+/* No depth or node cap, AI_DEFAULT_TIME_MS hard limit. */
+void ai_default_limits(AiSearchLimits *limits);
+void ai_limits_for_difficulty(AiDifficulty difficulty, AiSearchLimits *limits);
+void ai_last_search_stats(AiSearchStats *stats);
+/* Passing NULL limits uses ai_default_limits. Returns false if there is no move to make. */
+bool ai_pick_move(const GameState *state, const AiSearchLimits *limits, Move *outMove);
+
+/*
+ * Independent engines, each with its own hash table, tables and search
+ * threads, for running several searches at once (e.g. self-play). The
+ * functions above drive one built-in instance; these mirror them. One
+ * instance must not be searched from two threads at the same time.
+ */
+typedef struct AiInstance AiInstance;
+
+/* NULL if out of memory; configure with ai_instance_init before searching. */
+AiInstance *ai_create(void);
+void ai_destroy(AiInstance *ai);
+bool ai_instance_init(AiInstance *ai, const AiConfig *config);
+void ai_instance_shutdown(AiInstance *ai);
+void ai_instance_last_search_stats(const AiInstance *ai, AiSearchStats *stats);
+bool ai_instance_pick_move(AiInstance *ai, const GameState *state, const AiSearchLimits *limits, Move *outMove);
 
 #endif // AI_H
@@ -0,0 +1,88 @@
+#ifndef AI_WORKER_H
+#define AI_WORKER_H
+
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "ai.h"
+#include "game_logic.h"
+
+#define AI_WORKER_QUEUE_SIZE 8
+#define AI_WORKER_PONDER_REPLIES 8
+
+typedef struct {
+    unsigned int jobId;
+    bool hasMove;
+    Move move;
+} AiWorkerResult;
+
+/*
+ * Identifies a position for matching a request against pondered work: the
+ * Zobrist hash covers piece types and side to move, the scores decide the
+ * evaluation, and occupancy guards against hash collisions.
+ */
+typedef struct {
+    uint64_t hash;
+    Bitboard occupancy[PLAYER_COUNT];
+    int score[PLAYER_COUNT];
+} AiPositionKey;
+
+typedef struct {
+    AiPositionKey key;
+    bool hasMove;
+    Move move;
+} AiPonderResult;
+
+/*
+ * Runs ai_pick_move on a background thread. The caller posts a snapshot of
+ * the game, keeps rendering, and drains finished results with
+ * ai_worker_poll. Cancelling stops the running search and drops anything
+ * not yet drained, so a stale move can never reach a reloaded game.
+ *
+ * While the human is to move the worker can ponder: it guesses their
+ * likeliest replies and searches the positions after them with the same
+ * limits a real request would get. A request for a position it already
+ * answered is served from the ponder results at once; one for the position
+ * being searched right now adopts that search instead of starting over.
+ */
+typedef struct {
+    pthread_t thread;
+    pthread_mutex_t lock;
+    pthread_cond_t wake;
+    bool started;
+    bool shuttingDown;
+    bool hasJob;
+    bool busy;
+    unsigned int nextJobId;
+    GameState snapshot;
+    AiSearchLimits limits;
+    unsigned int snapshotJobId;
+    atomic_bool cancel;
+    bool hasPonderJob;
+    bool pondering;
+    GameState ponderRoot;
+    AiSearchLimits ponderLimits;
+    AiPositionKey ponderRootKey;
+    bool hasPonderRoot;
+    AiPositionKey ponderTarget;
+    bool hasPonderTarget;
+    unsigned int adoptJobId;
+    AiPonderResult ponderResults[AI_WORKER_PONDER_REPLIES];
+    size_t ponderResultCount;
+    AiWorkerResult queue[AI_WORKER_QUEUE_SIZE];
+    size_t queueHead;
+    size_t queueCount;
+} AiWorker;
+
+bool ai_worker_start(AiWorker *worker);
+void ai_worker_stop(AiWorker *worker);
+/* NULL limits uses ai_default_limits; the worker supplies its own stop flag. */
+unsigned int ai_worker_request(AiWorker *worker, const GameState *snapshot, const AiSearchLimits *limits);
+/* Starts pondering `snapshot` (the human to move); repeated calls for the same position are ignored. */
+void ai_worker_ponder(AiWorker *worker, const GameState *snapshot, const AiSearchLimits *limits);
+void ai_worker_cancel(AiWorker *worker);
+bool ai_worker_pending(AiWorker *worker);
+bool ai_worker_poll(AiWorker *worker, AiWorkerResult *outResult);
+
+#endif // AI_WORKER_H
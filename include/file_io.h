@@ -2,6 +2,7 @@
 #define FILE_IO_H
 
 #include <stdbool.h>
+#include <stdio.h>
 #include "game_logic.h"
 #include "chat.h"
 
@@ -9,5 +10,10 @@
 
 bool save_game_to_path(const GameState *state, const ChatLog *log, const char *path);
 bool load_game_from_path(GameState *state, ChatLog *log, const char *path);
+/*
+ * Reads one save from the current position of `f`, leaving the rest of the
+ * stream unread. On failure `state` is left exactly as it was.
+ */
+bool load_game_from_stream(GameState *state, ChatLog *log, FILE *f);
 
 #endif // FILE_IO_H
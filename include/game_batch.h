@@ -0,0 +1,75 @@
+#ifndef GAME_BATCH_H
+#define GAME_BATCH_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "game_logic.h"
+
+/*
+ * How game_batch_generate runs: a plain C loop, or x86-64 SIMD handling two
+ * (SSE2) or four (AVX2) bitboards per instruction. All give identical
+ * results; game_batch_init picks the best the CPU supports. Eight
+ * bitboards per instruction would need AVX-512.
+ */
+typedef enum {
+    GAME_BATCH_SCALAR = 0,
+    GAME_BATCH_SSE2,
+    GAME_BATCH_AVX2,
+    GAME_BATCH_KERNEL_COUNT
+} GameBatchKernel;
+
+/*
+ * Many independent games stored structure-of-arrays: one array per field,
+ * indexed by game. Move generation and game-over detection are single
+ * loops over the bitboard arrays with no per-game branching, so the
+ * compiler can vectorise them and the cost of a call is shared by every
+ * game in the batch. The rules are those of game_is_valid_move and
+ * game_apply_move; piece types never affect them but are carried along so
+ * a game converts back to the same GameState.
+ *
+ * targets[d][i] holds the destination squares of game i's side to move for
+ * column delta d - 1, as refreshed by game_batch_generate and after every
+ * batched move.
+ */
+typedef struct {
+    GameBatchKernel kernel;
+    size_t capacity;
+    size_t count;
+    Bitboard *occupancy[PLAYER_COUNT];
+    Bitboard *pieces[PIECE_TYPE_COUNT];
+    Bitboard *targets[3];
+    int32_t *score[PLAYER_COUNT];
+    uint8_t *currentPlayer;
+    uint8_t *isGameOver;
+} GameBatch;
+
+bool game_batch_init(GameBatch *batch, size_t capacity);
+void game_batch_free(GameBatch *batch);
+/* Puts `count` games at the start layout (at most the capacity). */
+void game_batch_reset(GameBatch *batch, size_t count);
+/* Copies a game in, growing count if needed; run game_batch_generate before moving. */
+bool game_batch_set(GameBatch *batch, size_t index, const GameState *state);
+/* Rebuilds the board and hash; the mode is MODE_NONE and the game is not paused. */
+void game_batch_get(const GameBatch *batch, size_t index, GameState *state);
+
+bool game_batch_kernel_supported(GameBatchKernel kernel);
+const char *game_batch_kernel_name(GameBatchKernel kernel);
+/* Switches the generator, e.g. to compare kernels; false if this CPU lacks it. */
+bool game_batch_set_kernel(GameBatch *batch, GameBatchKernel kernel);
+
+/* Refreshes targets and isGameOver for every game. */
+void game_batch_generate(GameBatch *batch);
+size_t game_batch_move_count(const GameBatch *batch, size_t index);
+/* Same moves in the same order as game_list_moves for that game. */
+size_t game_batch_list_moves(const GameBatch *batch, size_t index, Move *moves, size_t maxMoves);
+
+/*
+ * Plays moves[i] in game i for every game still running. A move that is not
+ * legal leaves its game untouched. Returns the number of games moved.
+ */
+size_t game_batch_apply(GameBatch *batch, const Move *moves);
+/* Plays one uniformly random legal move in every running game; returns the number moved. */
+size_t game_batch_play_random(GameBatch *batch, uint64_t *rng);
+
+#endif // GAME_BATCH_H
@@ -3,6 +3,7 @@
 
 #include <stdbool.h>
 #include <stddef.h>
+#include <stdint.h>
 
 #define BOARD_SIZE 8
 #define MAX_MOVES_PER_TURN 64
@@ -37,14 +38,49 @@ typedef struct {
     Position to;
 } Move;
 
-typedef struct {
-    bool occupied;
-    PieceType type;
-    Player owner;
-} Square;
+/*
+ * One byte per square so the whole board is 64 bytes: bit 0 is set when the
+ * square is occupied, bit 1 holds the owner and bits 2-3 the piece type.
+ * An empty square is always 0; use the square_* accessors to read it.
+ */
+typedef uint8_t Square;
+
+#define SQUARE_EMPTY ((Square)0)
+
+static inline Square square_make(Player owner, PieceType type) {
+    return (Square)(1u | ((unsigned)owner << 1) | ((unsigned)type << 2));
+}
+
+static inline bool square_is_occupied(Square sq) {
+    return (sq & 1u) != 0;
+}
+
+static inline Player square_owner(Square sq) {
+    return (Player)((sq >> 1) & 1u);
+}
+
+static inline PieceType square_type(Square sq) {
+    return (PieceType)((sq >> 2) & 3u);
+}
+
+/* One bit per square, bit index = row * BOARD_SIZE + col. */
+typedef uint64_t Bitboard;
+
+/* Piece list entry of a type the side no longer has. */
+#define PIECE_SQUARE_NONE 0xFF
 
 typedef struct {
     Square board[BOARD_SIZE][BOARD_SIZE];
+    Bitboard occupancy[PLAYER_COUNT];
+    Bitboard pieces[PIECE_TYPE_COUNT];
+    /*
+     * Piece lists: the square index of each side's piece of each type, or
+     * PIECE_SQUARE_NONE. A side starts with one piece per type and never
+     * gains any, so moving a piece rewrites a single entry.
+     */
+    uint8_t pieceSquare[PLAYER_COUNT][PIECE_TYPE_COUNT];
+    uint64_t hash; /* Zobrist key of pieces and side to move */
+    int mobility[PLAYER_COUNT]; /* legal moves per side, updated by every move */
     Player currentPlayer;
     int score[PLAYER_COUNT];
     GameMode mode;
@@ -52,13 +88,30 @@ typedef struct {
     bool isGameOver;
 } GameState;
 
+/* Everything game_unmake_move needs to take back one game_make_move. */
+typedef struct {
+    Move move;
+    Square captured;
+    int previousScore;
+    int previousMobility[PLAYER_COUNT];
+    bool previousGameOver;
+} MoveUndo;
+
 void game_init(GameState *state, GameMode mode);
 void game_reset(GameState *state, GameMode mode);
 Player game_get_opponent(Player player);
 bool game_is_valid_position(Position pos);
 bool game_is_valid_move(const GameState *state, Position from, Position to);
 bool game_apply_move(GameState *state, Position from, Position to);
+bool game_make_move(GameState *state, Move move, MoveUndo *undo);
+void game_unmake_move(GameState *state, const MoveUndo *undo);
 size_t game_list_moves(const GameState *state, Player player, Move *moves, size_t maxMoves);
+/* Only the moves that capture, i.e. diagonal steps onto an opponent piece. */
+size_t game_list_captures(const GameState *state, Player player, Move *moves, size_t maxMoves);
+/* O(1): reads the mobility count kept by the state. */
 bool game_has_any_moves(const GameState *state, Player player);
+/* Rebuilds everything derived from the board; false if a side has two pieces of one type. */
+bool game_sync_board(GameState *state);
+uint64_t game_compute_hash(const GameState *state);
 
 #endif // GAME_LOGIC_H
@@ -0,0 +1,67 @@
+#ifndef SOLUTION_TABLE_H
+#define SOLUTION_TABLE_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "game_logic.h"
+
+/*
+ * Exact game values written by the offline solver (tools/solver.c).
+ *
+ * Every piece moves the same way, so a position is identified by which
+ * squares are occupied, which of those pieces are WHITE and the side to
+ * move; piece types never matter. A slot stores the occupied bitboard plus
+ * a 16-bit colour mask over its set bits (ascending square order), which
+ * caps solvable positions at 16 pieces and keeps a slot at 16 bytes. The
+ * stored value is the capture difference the side to move will add from
+ * here to the end of the game under perfect play by both sides.
+ *
+ * The file is a SolutionTableHeader followed by a power-of-two array of
+ * SolutionSlot, open-addressed with linear probing, in host byte order. It
+ * is mapped read-only and probed in place.
+ */
+#define SOLUTION_TABLE_MAGIC "CHSOLVE1"
+#define SOLUTION_TABLE_VERSION 1
+#define SOLUTION_MAX_PIECES 16
+
+typedef struct {
+    char magic[8];
+    uint32_t version;
+    uint32_t slotSize;
+    uint64_t slotCount;
+    uint64_t entryCount;
+} SolutionTableHeader;
+
+/* An all-zero slot is empty: a reachable position always has a piece. */
+typedef struct {
+    uint64_t occupied;
+    uint16_t whiteMask;
+    uint8_t sideToMove;
+    int8_t value;
+    uint32_t reserved;
+} SolutionSlot;
+
+typedef struct {
+    uint64_t occupied;
+    uint16_t whiteMask;
+    uint8_t sideToMove;
+} SolutionKey;
+
+typedef struct {
+    void *mapping;
+    size_t mappingSize;
+    const SolutionSlot *slots;
+    uint64_t slotMask;
+    uint64_t entryCount;
+} SolutionTable;
+
+bool solution_table_open(SolutionTable *table, const char *path);
+void solution_table_close(SolutionTable *table);
+bool solution_table_probe(const SolutionTable *table, const GameState *state, int *outValue);
+
+/* Shared with the solver so writer and reader agree on keys and slot placement. */
+bool solution_key_from_state(const GameState *state, SolutionKey *outKey);
+SolutionSlot *solution_slot_find(SolutionSlot *slots, uint64_t slotMask, const SolutionKey *key);
+
+#endif // SOLUTION_TABLE_H
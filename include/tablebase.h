@@ -0,0 +1,49 @@
+#ifndef TABLEBASE_H
+#define TABLEBASE_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "game_logic.h"
+
+/*
+ * Endgame tablebase for positions with 2..TABLEBASE_MAX_PIECES pieces,
+ * written by tools/tbgen.c and probed in place through a read-only mapping.
+ *
+ * Positions are grouped into classes by (white count, black count), both at
+ * least one; a side with no pieces can never capture again, so those
+ * positions are worth 0 and not stored. Within a class the index is
+ *   (rank(white squares) * C(64, blackCount) + rank(black squares)) * 2 + side
+ * with combinations ranked in colex order. Each entry is a 4-bit nibble
+ * holding value + TABLEBASE_VALUE_BIAS (0 = no such position, e.g. shared
+ * squares), where value is the capture difference the side to move forces
+ * by the end of the game. Piece types never affect movement and are ignored.
+ */
+#define TABLEBASE_MAGIC "CHTBASE1"
+#define TABLEBASE_VERSION 1
+#define TABLEBASE_MAX_PIECES 4
+#define TABLEBASE_VALUE_BIAS 8
+
+typedef struct {
+    char magic[8];
+    uint32_t version;
+    uint32_t maxPieces;
+    uint64_t entryCount;
+} TablebaseHeader;
+
+typedef struct {
+    void *mapping;
+    size_t mappingSize;
+    const uint8_t *data;
+    uint64_t entryCount;
+} Tablebase;
+
+bool tablebase_open(Tablebase *tb, const char *path);
+void tablebase_close(Tablebase *tb);
+bool tablebase_probe(const Tablebase *tb, const GameState *state, int *outValue);
+
+/* Shared with the generator. */
+uint64_t tablebase_entry_count(void);
+bool tablebase_entry_index(Bitboard white, Bitboard black, Player sideToMove, uint64_t *outIndex);
+
+#endif // TABLEBASE_H
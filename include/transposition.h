@@ -0,0 +1,51 @@
+#ifndef TRANSPOSITION_H
+#define TRANSPOSITION_H
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "game_logic.h"
+
+#define TT_DEFAULT_SIZE_MB 16
+#define TT_MAX_DEPTH 127
+
+typedef enum {
+    TT_BOUND_NONE = 0,
+    TT_BOUND_EXACT,
+    TT_BOUND_LOWER,
+    TT_BOUND_UPPER
+} TtBound;
+
+typedef struct {
+    int depth;
+    TtBound bound;
+    int score;
+    bool hasMove;
+    Move bestMove;
+} TtEntry;
+
+/*
+ * One slot is two 64-bit words: the packed entry and the key XORed with it.
+ * Readers accept a slot only if both words still agree, so concurrent
+ * writers can tear a slot without a reader ever trusting the torn result.
+ */
+typedef struct {
+    _Atomic uint64_t check;
+    _Atomic uint64_t data;
+} TtSlot;
+
+typedef struct {
+    TtSlot *slots;
+    size_t bucketMask;
+    _Atomic unsigned int generation;
+} TranspositionTable;
+
+bool tt_init(TranspositionTable *table, size_t megabytes);
+void tt_free(TranspositionTable *table);
+void tt_clear(TranspositionTable *table);
+void tt_new_search(TranspositionTable *table);
+bool tt_probe(const TranspositionTable *table, uint64_t key, TtEntry *outEntry);
+void tt_store(TranspositionTable *table, uint64_t key, int depth, TtBound bound, int score, const Move *bestMove);
+
+#endif // TRANSPOSITION_H
@@ -1,24 +1,1304 @@
+#define _POSIX_C_SOURCE 200809L
+
 #include "ai.h"
+#include "solution_table.h"
+#include "tablebase.h"
+#include "transposition.h"
 
+#include <errno.h>
+#include <math.h>
+#include <pthread.h>
+#include <stdatomic.h>
 #include <stdlib.h>
 #include <time.h>
 
-void ai_init(void) {
-    srand((unsigned int)time(NULL));
+#define AI_INFINITY 1000000
+#define AI_WIN_SCORE 100000
+#define AI_CAPTURE_WEIGHT 100
+#define AI_ADVANCE_WEIGHT 4
+#define AI_TIME_CHECK_MASK 255UL
+#define AI_MIN_STOP_MARGIN_US 2000ULL
+#define AI_REPLY_LEAD_US 500ULL
+#define AI_WIN_THRESHOLD (AI_WIN_SCORE - 1000)
+#define AI_SOLVED_DEPTH TT_MAX_DEPTH
+#define AI_KILLER_SLOTS 2
+#define AI_ORDER_TT (1 << 30)
+#define AI_ORDER_CAPTURE (1 << 29)
+#define AI_ORDER_KILLER (1 << 28)
+#define AI_HISTORY_LIMIT (1 << 20)
+#define AI_SQUARE_COUNT (BOARD_SIZE * BOARD_SIZE)
+
+#define MCTS_EXPLORATION 1.41
+#define MCTS_EXPAND_VISITS 2U
+#define MCTS_ARENA_BLOCK_NODES 4096
+#define MCTS_MAX_TREE_NODES (1UL << 20)
+#define MCTS_MAX_PATH 256
+
+/* State shared by every thread searching the same root. */
+typedef struct {
+    AiInstance *ai;
+    GameState root;
+    Move rootMoves[MAX_MOVES_PER_TURN];
+    size_t rootCount;
+    int maxDepth;
+    unsigned long maxNodes;
+    unsigned long long softDeadlineUs;
+    unsigned long long hardDeadlineUs;
+    const atomic_bool *stopRequest;
+    AiInfoCallback onInfo;
+    void *infoUserData;
+    unsigned long long startUs;
+    atomic_bool stop;
+    atomic_ulong nodes;
+    pthread_mutex_t resultLock; /* guards everything below */
+    pthread_cond_t finishedSignal;
+    bool finished; /* the main search thread has returned */
+    bool replied;  /* the caller has taken the result; no more info is reported */
+    int bestQuality; /* 2 * depth for a finished iteration, one less for a partial one */
+    Move bestMove;
+} SharedSearch;
+
+/* Per-thread search state; the ordering tables live for one ai_pick_move. */
+typedef struct {
+    SharedSearch *shared;
+    unsigned long nodes;
+    bool stopped;
+    bool reachedHorizon;
+    Move killers[AI_MAX_DEPTH][AI_KILLER_SLOTS];
+    int history[AI_SQUARE_COUNT][AI_SQUARE_COUNT];
+} SearchContext;
+
+typedef struct {
+    SharedSearch *shared;
+    int startDepth;
+    bool isMain; /* reports progress and ends the search when it returns */
+} HelperArgs;
+
+enum {
+    MCTS_LEAF = 0,
+    MCTS_EXPANDING,
+    MCTS_EXPANDED
+};
+
+typedef struct MctsNode {
+    struct MctsNode *children;
+    atomic_uint visits;
+    atomic_uint reward; /* half-points won by the player who made `move` */
+    atomic_int expansion;
+    unsigned int childCount;
+    Move move;
+} MctsNode;
+
+typedef struct MctsBlock {
+    struct MctsBlock *next;
+    size_t used;
+    size_t capacity;
+    MctsNode nodes[];
+} MctsBlock;
+
+typedef struct {
+    MctsBlock *blocks;
+} MctsArena;
+
+typedef struct {
+    AiInstance *ai;
+    GameState root;
+    MctsNode rootNode;
+    unsigned long long deadlineUs;
+    unsigned long maxPlayouts;
+    const atomic_bool *stopRequest;
+    atomic_bool stop;
+    atomic_ulong playouts;
+    atomic_ulong treeNodes;
+    atomic_int participants; /* threads, the caller included, still using the tree */
+    pthread_mutex_t finishLock;
+    pthread_cond_t finishedSignal;
+    bool finished; /* some worker has stopped */
+} MctsSearch;
+
+typedef struct {
+    MctsSearch *search;
+    MctsArena arena;
+    uint64_t rng;
+} MctsWorker;
+
+/*
+ * One engine: its configuration, tables and the state of its last search.
+ * The ai_* calls without an instance use defaultInstance.
+ */
+struct AiInstance {
+    AiEngine engine;
+    bool orderMoves;
+    int threadCount;
+    TranspositionTable table;
+    SolutionTable solutions;
+    Tablebase endgame;
+    AiSearchStats lastStats;
+    unsigned long long stopMarginUs; /* kept back from every hard limit; see learn_stop_margin */
+
+    SharedSearch alphaBetaSearch;
+    bool alphaBetaActive;
+    HelperArgs helperArgs[AI_MAX_THREADS];
+    MctsSearch mctsSearch;
+    MctsWorker mctsWorkers[AI_MAX_THREADS];
+    int mctsWorkerCount;
+    bool mctsActive;
+    pthread_t helpers[AI_MAX_THREADS];
+    int helperCount;
+};
+
+static AiInstance defaultInstance = {
+    .engine = AI_ENGINE_ALPHA_BETA,
+    .orderMoves = true,
+    .threadCount = 1,
+    .stopMarginUs = AI_MIN_STOP_MARGIN_US,
+};
+
+static void finish_previous_search(AiInstance *ai);
+
+static unsigned long long now_us(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (unsigned long long)ts.tv_sec * 1000000ULL + (unsigned long long)ts.tv_nsec / 1000ULL;
+}
+
+void ai_default_config(AiConfig *config) {
+    if (!config) {
+        return;
+    }
+    config->hashSizeMb = TT_DEFAULT_SIZE_MB;
+    config->threads = 1;
+    config->solutionPath = NULL;
+    config->tablebasePath = NULL;
+    config->engine = AI_ENGINE_ALPHA_BETA;
+    config->orderMoves = true;
+}
+
+AiInstance *ai_create(void) {
+    AiInstance *ai = calloc(1, sizeof(*ai));
+    if (ai) {
+        ai->engine = AI_ENGINE_ALPHA_BETA;
+        ai->orderMoves = true;
+        ai->threadCount = 1;
+        ai->stopMarginUs = AI_MIN_STOP_MARGIN_US;
+    }
+    return ai;
 }
 
-bool ai_pick_move(const GameState *state, Move *outMove) {
-    if (!state || !outMove) {
+void ai_destroy(AiInstance *ai) {
+    if (!ai || ai == &defaultInstance) {
+        return;
+    }
+    ai_instance_shutdown(ai);
+    free(ai);
+}
+
+bool ai_instance_init(AiInstance *ai, const AiConfig *config) {
+    if (!ai) {
         return false;
     }
+    AiConfig defaults;
+    if (!config) {
+        ai_default_config(&defaults);
+        config = &defaults;
+    }
+
+    finish_previous_search(ai);
+    ai->engine = config->engine;
+    ai->orderMoves = config->orderMoves;
+    ai->threadCount = config->threads;
+    if (ai->threadCount < 1) {
+        ai->threadCount = 1;
+    } else if (ai->threadCount > AI_MAX_THREADS) {
+        ai->threadCount = AI_MAX_THREADS;
+    }
+
+    bool ok = true;
+    solution_table_close(&ai->solutions);
+    if (config->solutionPath && !solution_table_open(&ai->solutions, config->solutionPath)) {
+        ok = false;
+    }
+    tablebase_close(&ai->endgame);
+    if (config->tablebasePath && !tablebase_open(&ai->endgame, config->tablebasePath)) {
+        ok = false;
+    }
+
+    tt_free(&ai->table);
+    if (config->hashSizeMb > 0 && !tt_init(&ai->table, config->hashSizeMb)) {
+        ok = false;
+    }
+    return ok;
+}
+
+void ai_instance_shutdown(AiInstance *ai) {
+    if (!ai) {
+        return;
+    }
+    finish_previous_search(ai);
+    tt_free(&ai->table);
+    solution_table_close(&ai->solutions);
+    tablebase_close(&ai->endgame);
+}
+
+bool ai_init(const AiConfig *config) {
+    return ai_instance_init(&defaultInstance, config);
+}
+
+void ai_shutdown(void) {
+    ai_instance_shutdown(&defaultInstance);
+}
+
+void ai_default_limits(AiSearchLimits *limits) {
+    if (!limits) {
+        return;
+    }
+    limits->maxDepth = 0;
+    limits->maxNodes = 0;
+    limits->softTimeMs = 0;
+    limits->hardTimeMs = AI_DEFAULT_TIME_MS;
+    limits->stop = NULL;
+    limits->onInfo = NULL;
+    limits->infoUserData = NULL;
+}
+
+/*
+ * Easy and medium are held back by depth as much as by time; hard keeps
+ * deepening until the hard limit and so always spends its full budget.
+ * Perfect gets four times that for positions its tables do not cover.
+ */
+void ai_limits_for_difficulty(AiDifficulty difficulty, AiSearchLimits *limits) {
+    if (!limits) {
+        return;
+    }
+    ai_default_limits(limits);
+    switch (difficulty) {
+    case AI_DIFFICULTY_EASY:
+        limits->maxDepth = 2;
+        limits->hardTimeMs = 50;
+        break;
+    case AI_DIFFICULTY_MEDIUM:
+        limits->maxDepth = 6;
+        limits->softTimeMs = 50;
+        limits->hardTimeMs = 100;
+        break;
+    case AI_DIFFICULTY_PERFECT:
+        limits->hardTimeMs = 1000;
+        break;
+    case AI_DIFFICULTY_HARD:
+    default:
+        limits->hardTimeMs = 250;
+        break;
+    }
+}
+
+/* The deadline `ms` from `startUs`, less `marginUs`; 0 = none. */
+static unsigned long long deadline_after(unsigned long long startUs, unsigned int ms, unsigned long long marginUs) {
+    if (ms == 0) {
+        return 0;
+    }
+    unsigned long long budgetUs = (unsigned long long)ms * 1000ULL;
+    return startUs + (budgetUs > marginUs ? budgetUs - marginUs : 1);
+}
+
+/* Timed waits use the same clock as now_us. */
+static void init_finished_signal(pthread_cond_t *signal) {
+    pthread_condattr_t attr;
+    pthread_condattr_init(&attr);
+    pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+    pthread_cond_init(signal, &attr);
+    pthread_condattr_destroy(&attr);
+}
+
+/*
+ * With `lock` held, sleeps until `*finished` is set or `deadlineUs` (0 =
+ * none) passes. A thread woken from sleep is scheduled far sooner than a
+ * busy search thread gets back onto a loaded CPU, so the caller waits here
+ * instead of searching and can reply on time whatever the searchers do.
+ */
+static void wait_for_search(pthread_cond_t *signal, pthread_mutex_t *lock, const bool *finished,
+                            unsigned long long deadlineUs) {
+    struct timespec until = { (time_t)(deadlineUs / 1000000ULL), (long)(deadlineUs % 1000000ULL) * 1000L };
+    while (!*finished) {
+        if (!deadlineUs) {
+            pthread_cond_wait(signal, lock);
+        } else if (pthread_cond_timedwait(signal, lock, &until) == ETIMEDOUT) {
+            break;
+        }
+    }
+}
+
+void ai_instance_last_search_stats(const AiInstance *ai, AiSearchStats *stats) {
+    if (ai && stats) {
+        *stats = ai->lastStats;
+    }
+}
+
+void ai_last_search_stats(AiSearchStats *stats) {
+    ai_instance_last_search_stats(&defaultInstance, stats);
+}
+
+/* Rows a player's pieces have travelled from their own back rank. */
+static int advancement(Bitboard pieces, Player player) {
+    int total = 0;
+    for (; pieces; pieces &= pieces - 1) {
+        int row = __builtin_ctzll(pieces) / BOARD_SIZE;
+        total += (player == PLAYER_WHITE) ? (BOARD_SIZE - 1 - row) : row;
+    }
+    return total;
+}
+
+/* Static evaluation from the point of view of the side to move. */
+static int evaluate(const GameState *state) {
+    Player me = state->currentPlayer;
+    Player opponent = game_get_opponent(me);
+    int captures = state->score[me] - state->score[opponent];
+    int advance = advancement(state->occupancy[me], me) - advancement(state->occupancy[opponent], opponent);
+    return captures * AI_CAPTURE_WEIGHT + advance * AI_ADVANCE_WEIGHT;
+}
+
+/*
+ * The side to move is stuck, so the scores are final. Wins and losses dwarf
+ * any heuristic value; quicker wins and slower losses are preferred.
+ */
+static int terminal_score(const GameState *state, int ply) {
+    Player me = state->currentPlayer;
+    int diff = state->score[me] - state->score[game_get_opponent(me)];
+    if (diff > 0) {
+        return AI_WIN_SCORE - ply;
+    }
+    if (diff < 0) {
+        return -AI_WIN_SCORE + ply;
+    }
+    return 0;
+}
+
+/*
+ * Score for a position whose remaining capture difference is known exactly
+ * from a table. Proven results rank just below wins found by search, so a
+ * win the search can already see is still preferred.
+ */
+static int exact_score(const GameState *state, int value, int ply) {
+    Player me = state->currentPlayer;
+    int diff = state->score[me] - state->score[game_get_opponent(me)] + value;
+    if (diff > 0) {
+        return AI_WIN_SCORE - AI_MAX_DEPTH - ply;
+    }
+    if (diff < 0) {
+        return -AI_WIN_SCORE + AI_MAX_DEPTH + ply;
+    }
+    return 0;
+}
+
+/* Looks the position up in the solver table, then in the endgame tablebase. */
+static bool probe_exact(const AiInstance *ai, const GameState *state, int *outValue) {
+    return solution_table_probe(&ai->solutions, state, outValue) ||
+           tablebase_probe(&ai->endgame, state, outValue);
+}
+
+/*
+ * The evaluation depends on the score difference as well as the pieces, so
+ * it is folded into the key; a position reached with different capture
+ * counts (e.g. from another save) must not share an entry.
+ */
+static uint64_t search_key(const GameState *state) {
+    int diff = state->score[PLAYER_WHITE] - state->score[PLAYER_BLACK];
+    return state->hash ^ ((uint64_t)(unsigned int)(diff + 1024) * 0xD6E8FEB86659FD93ULL);
+}
+
+/* Win/loss scores are stored relative to the node, not the root. */
+static int score_to_tt(int score, int ply) {
+    if (score >= AI_WIN_THRESHOLD) {
+        return score + ply;
+    }
+    if (score <= -AI_WIN_THRESHOLD) {
+        return score - ply;
+    }
+    return score;
+}
+
+static int score_from_tt(int score, int ply) {
+    if (score >= AI_WIN_THRESHOLD) {
+        return score - ply;
+    }
+    if (score <= -AI_WIN_THRESHOLD) {
+        return score + ply;
+    }
+    return score;
+}
+
+static bool same_move(Move a, Move b) {
+    return a.from.row == b.from.row && a.from.col == b.from.col && a.to.row == b.to.row && a.to.col == b.to.col;
+}
+
+/* Moves `move` to the front of the list if present. */
+static void move_to_front(Move *moves, size_t count, Move move) {
+    for (size_t i = 1; i < count; ++i) {
+        if (same_move(moves[i], move)) {
+            Move tmp = moves[0];
+            moves[0] = moves[i];
+            moves[i] = tmp;
+            return;
+        }
+    }
+}
+
+static int square_number(Position pos) {
+    return pos.row * BOARD_SIZE + pos.col;
+}
+
+/*
+ * Sorts the moves best-first: the hash move, then captures (the only
+ * moves that score), then this ply's killer moves, then the rest by their
+ * history count. With ordering disabled only the hash move is moved up.
+ */
+static void order_moves(const SearchContext *ctx, const GameState *state, Move *moves, size_t count, int ply, const Move *hashMove) {
+    if (!ctx->shared->ai->orderMoves) {
+        if (hashMove) {
+            move_to_front(moves, count, *hashMove);
+        }
+        return;
+    }
+
+    Bitboard enemy = state->occupancy[game_get_opponent(state->currentPlayer)];
+    const Move *killers = ctx->killers[ply];
+    int scores[MAX_MOVES_PER_TURN];
+    for (size_t i = 0; i < count; ++i) {
+        Move move = moves[i];
+        if (hashMove && same_move(move, *hashMove)) {
+            scores[i] = AI_ORDER_TT;
+        } else if (enemy & ((Bitboard)1 << square_number(move.to))) {
+            scores[i] = AI_ORDER_CAPTURE;
+        } else if (same_move(move, killers[0])) {
+            scores[i] = AI_ORDER_KILLER + 1;
+        } else if (same_move(move, killers[1])) {
+            scores[i] = AI_ORDER_KILLER;
+        } else {
+            scores[i] = ctx->history[square_number(move.from)][square_number(move.to)];
+        }
+    }
+
+    /* Insertion sort: the lists are short and ties keep generator order. */
+    for (size_t i = 1; i < count; ++i) {
+        Move move = moves[i];
+        int score = scores[i];
+        size_t j = i;
+        for (; j > 0 && scores[j - 1] < score; --j) {
+            moves[j] = moves[j - 1];
+            scores[j] = scores[j - 1];
+        }
+        moves[j] = move;
+        scores[j] = score;
+    }
+}
+
+/* A quiet move caused a beta cutoff: remember it for siblings and later iterations. */
+static void record_cutoff(SearchContext *ctx, Move move, int depth, int ply) {
+    Move *killers = ctx->killers[ply];
+    if (!same_move(killers[0], move)) {
+        killers[1] = killers[0];
+        killers[0] = move;
+    }
+
+    int *entry = &ctx->history[square_number(move.from)][square_number(move.to)];
+    *entry += depth * depth;
+    if (*entry >= AI_HISTORY_LIMIT) {
+        for (int from = 0; from < AI_SQUARE_COUNT; ++from) {
+            for (int to = 0; to < AI_SQUARE_COUNT; ++to) {
+                ctx->history[from][to] /= 2;
+            }
+        }
+    }
+}
+
+/*
+ * Nodes are published to the shared counter in batches; the local remainder
+ * is added back so a single thread still stops at exactly maxNodes.
+ */
+static bool out_of_budget(SearchContext *ctx) {
+    SharedSearch *shared = ctx->shared;
+    if ((ctx->nodes & AI_TIME_CHECK_MASK) == 0) {
+        atomic_fetch_add_explicit(&shared->nodes, AI_TIME_CHECK_MASK + 1, memory_order_relaxed);
+        if (atomic_load_explicit(&shared->stop, memory_order_relaxed)) {
+            return true;
+        }
+        if (shared->stopRequest && atomic_load_explicit(shared->stopRequest, memory_order_relaxed)) {
+            return true;
+        }
+        if (shared->hardDeadlineUs && now_us() >= shared->hardDeadlineUs) {
+            return true;
+        }
+    }
+    if (shared->maxNodes) {
+        unsigned long total = atomic_load_explicit(&shared->nodes, memory_order_relaxed) + (ctx->nodes & AI_TIME_CHECK_MASK);
+        if (total >= shared->maxNodes) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/*
+ * Captures are the only thing that changes the score, so the horizon is
+ * not evaluated until the capture exchanges running through it are over.
+ * The side to move may stand pat on the static evaluation instead of
+ * capturing; only capture moves are searched.
+ */
+static int quiescence(SearchContext *ctx, GameState *state, int ply, int alpha, int beta) {
+    if (state->isGameOver) {
+        return terminal_score(state, ply);
+    }
+
+    ++ctx->nodes;
+    if (ctx->stopped || out_of_budget(ctx)) {
+        ctx->stopped = true;
+        return 0;
+    }
+
+    int best = evaluate(state);
+    if (best >= beta) {
+        return best;
+    }
+    if (best > alpha) {
+        alpha = best;
+    }
+
+    Move moves[MAX_MOVES_PER_TURN];
+    size_t count = game_list_captures(state, state->currentPlayer, moves, MAX_MOVES_PER_TURN);
+    for (size_t i = 0; i < count; ++i) {
+        MoveUndo undo;
+        if (!game_make_move(state, moves[i], &undo)) {
+            continue;
+        }
+        int value = -quiescence(ctx, state, ply + 1, -beta, -alpha);
+        game_unmake_move(state, &undo);
+        if (ctx->stopped) {
+            return 0;
+        }
+        if (value > best) {
+            best = value;
+        }
+        if (value > alpha) {
+            alpha = value;
+        }
+        if (alpha >= beta) {
+            break;
+        }
+    }
+    return best;
+}
+
+/*
+ * ctx->reachedHorizon tells whether any line below a node was cut off by
+ * the depth limit. Nodes whose whole subtree ran to the end of the game are
+ * stored with AI_SOLVED_DEPTH so they satisfy probes at any depth.
+ */
+static int negamax(SearchContext *ctx, GameState *state, int depth, int ply, int alpha, int beta) {
+    if (state->isGameOver) {
+        return terminal_score(state, ply);
+    }
+    AiInstance *ai = ctx->shared->ai;
+    int exact;
+    if (probe_exact(ai, state, &exact)) {
+        return exact_score(state, exact, ply);
+    }
+    if (depth == 0) {
+        ctx->reachedHorizon = true;
+        return quiescence(ctx, state, ply, alpha, beta);
+    }
+
+    ++ctx->nodes;
+    if (ctx->stopped || out_of_budget(ctx)) {
+        ctx->stopped = true;
+        return 0;
+    }
+
+    uint64_t key = search_key(state);
+    TtEntry entry;
+    bool hasEntry = tt_probe(&ai->table, key, &entry);
+    if (hasEntry && entry.depth >= depth) {
+        int stored = score_from_tt(entry.score, ply);
+        if (entry.bound == TT_BOUND_EXACT ||
+            (entry.bound == TT_BOUND_LOWER && stored >= beta) ||
+            (entry.bound == TT_BOUND_UPPER && stored <= alpha)) {
+            if (entry.depth < AI_SOLVED_DEPTH) {
+                ctx->reachedHorizon = true;
+            }
+            return stored;
+        }
+    }
+
+    Move moves[MAX_MOVES_PER_TURN];
+    size_t count = game_list_moves(state, state->currentPlayer, moves, MAX_MOVES_PER_TURN);
+    order_moves(ctx, state, moves, count, ply, (hasEntry && entry.hasMove) ? &entry.bestMove : NULL);
+
+    bool outerHorizon = ctx->reachedHorizon;
+    ctx->reachedHorizon = false;
+
+    int originalAlpha = alpha;
+    int best = -AI_INFINITY;
+    Move bestMove = moves[0];
+    for (size_t i = 0; i < count; ++i) {
+        MoveUndo undo;
+        if (!game_make_move(state, moves[i], &undo)) {
+            continue;
+        }
+        int value = -negamax(ctx, state, depth - 1, ply + 1, -beta, -alpha);
+        game_unmake_move(state, &undo);
+        if (ctx->stopped) {
+            return 0;
+        }
+        if (value > best) {
+            best = value;
+            bestMove = moves[i];
+        }
+        if (value > alpha) {
+            alpha = value;
+        }
+        if (alpha >= beta) {
+            if (!square_is_occupied(undo.captured) && ai->orderMoves) {
+                record_cutoff(ctx, moves[i], depth, ply);
+            }
+            break;
+        }
+    }
+
+    bool solved = !ctx->reachedHorizon;
+    ctx->reachedHorizon = ctx->reachedHorizon || outerHorizon;
+
+    TtBound bound = TT_BOUND_EXACT;
+    if (best <= originalAlpha) {
+        bound = TT_BOUND_UPPER;
+    } else if (best >= beta) {
+        bound = TT_BOUND_LOWER;
+    }
+    tt_store(&ai->table, key, solved ? AI_SOLVED_DEPTH : depth, bound, score_to_tt(best, ply), &bestMove);
+    return best;
+}
+
+/*
+ * Searches every root move to `depth`, trying `*bestMove` first, and
+ * returns how many were searched completely. An interrupted iteration
+ * still updates *bestMove once the first move is done: any later move
+ * that beat it was searched in full and is proven better.
+ */
+static size_t search_root(SearchContext *ctx, GameState *state, Move *moves, size_t count, int depth, Move *bestMove, int *outScore) {
+    move_to_front(moves, count, *bestMove);
+
+    int alpha = -AI_INFINITY;
+    Move iterationBest = moves[0];
+    for (size_t i = 0; i < count; ++i) {
+        MoveUndo undo;
+        if (!game_make_move(state, moves[i], &undo)) {
+            continue;
+        }
+        int value = -negamax(ctx, state, depth - 1, 1, -AI_INFINITY, -alpha);
+        game_unmake_move(state, &undo);
+        if (ctx->stopped) {
+            if (i > 0) {
+                *bestMove = iterationBest;
+            }
+            return i;
+        }
+        if (value > alpha) {
+            alpha = value;
+            iterationBest = moves[i];
+        }
+    }
+    *bestMove = iterationBest;
+    *outScore = alpha;
+    tt_store(&ctx->shared->ai->table, search_key(state), depth, TT_BOUND_EXACT, score_to_tt(alpha, 0), bestMove);
+    return count;
+}
+
+static void publish_result(SharedSearch *shared, int quality, Move move) {
+    pthread_mutex_lock(&shared->resultLock);
+    if (quality > shared->bestQuality) {
+        shared->bestQuality = quality;
+        shared->bestMove = move;
+    }
+    pthread_mutex_unlock(&shared->resultLock);
+}
+
+/* Follows the hash moves from the root, starting with `first`. */
+static size_t collect_pv(const AiInstance *ai, const GameState *root, Move first, Move *pv, size_t maxLength) {
+    GameState state = *root;
+    Move move = first;
+    size_t length = 0;
+    while (length < maxLength) {
+        MoveUndo undo;
+        if (!game_make_move(&state, move, &undo)) {
+            break;
+        }
+        pv[length++] = move;
+        TtEntry entry;
+        if (!tt_probe(&ai->table, search_key(&state), &entry) || !entry.hasMove) {
+            break;
+        }
+        move = entry.bestMove;
+    }
+    return length;
+}
+
+/* Reported under the result lock, so nothing reaches the callback once the caller has replied. */
+static void report_iteration(const SearchContext *ctx, const GameState *root, int depth, int score, Move best) {
+    SharedSearch *shared = ctx->shared;
+    pthread_mutex_lock(&shared->resultLock);
+    if (shared->replied) {
+        pthread_mutex_unlock(&shared->resultLock);
+        return;
+    }
+    AiSearchInfo info;
+    info.depth = depth;
+    info.score = score;
+    info.nodes = atomic_load_explicit(&shared->nodes, memory_order_relaxed) + (ctx->nodes & AI_TIME_CHECK_MASK);
+    info.elapsedUs = now_us() - shared->startUs;
+    info.pvLength = collect_pv(shared->ai, root, best, info.pv, (size_t)depth);
+    shared->onInfo(&info, shared->infoUserData);
+    pthread_mutex_unlock(&shared->resultLock);
+}
+
+static void iterative_deepening(SharedSearch *shared, int startDepth, bool reportInfo) {
+    GameState root = shared->root;
+    Move moves[MAX_MOVES_PER_TURN];
+    size_t count = shared->rootCount;
+    for (size_t i = 0; i < count; ++i) {
+        moves[i] = shared->rootMoves[i];
+    }
+
+    Move best = moves[0];
+    SearchContext ctx = { 0 };
+    ctx.shared = shared;
+
+    for (int depth = startDepth; depth <= shared->maxDepth; ++depth) {
+        ctx.reachedHorizon = false;
+        int score = 0;
+        size_t searched = search_root(&ctx, &root, moves, count, depth, &best, &score);
+        if (ctx.stopped) {
+            if (searched > 0) {
+                publish_result(shared, 2 * depth - 1, best);
+            }
+            break;
+        }
+        publish_result(shared, 2 * depth, best);
+        if (reportInfo && shared->onInfo) {
+            report_iteration(&ctx, &root, depth, score, best);
+        }
+        /* Every line ended before the horizon: the game tree is solved. */
+        if (!ctx.reachedHorizon) {
+            atomic_store_explicit(&shared->stop, true, memory_order_relaxed);
+            break;
+        }
+        /* Past the soft limit the next, deeper iteration would most likely be cut off. */
+        if (shared->softDeadlineUs && now_us() >= shared->softDeadlineUs) {
+            atomic_store_explicit(&shared->stop, true, memory_order_relaxed);
+            break;
+        }
+        if (atomic_load_explicit(&shared->stop, memory_order_relaxed)) {
+            break;
+        }
+    }
+    atomic_fetch_add_explicit(&shared->nodes, ctx.nodes & AI_TIME_CHECK_MASK, memory_order_relaxed);
+}
+
+static void *helper_main(void *arg) {
+    HelperArgs *args = arg;
+    SharedSearch *shared = args->shared;
+    iterative_deepening(shared, args->startDepth, args->isMain);
+    if (args->isMain) {
+        atomic_store_explicit(&shared->stop, true, memory_order_relaxed);
+        pthread_mutex_lock(&shared->resultLock);
+        shared->finished = true;
+        pthread_cond_signal(&shared->finishedSignal);
+        pthread_mutex_unlock(&shared->resultLock);
+    }
+    return NULL;
+}
+
+/*
+ * Picks the move with the best exact value from the solver table or the
+ * endgame tablebase. Fails if the position or any successor is missing,
+ * e.g. when the table was solved from a different root.
+ */
+static bool pick_solved_move(const AiInstance *ai, const GameState *state, const Move *moves, size_t count, Move *outMove) {
+    int rootValue;
+    if (!probe_exact(ai, state, &rootValue)) {
+        return false;
+    }
+
+    GameState child = *state;
+    int best = 0;
+    bool found = false;
+    for (size_t i = 0; i < count; ++i) {
+        MoveUndo undo;
+        int childValue;
+        if (!game_make_move(&child, moves[i], &undo)) {
+            continue;
+        }
+        bool known = probe_exact(ai, &child, &childValue);
+        int gain = (square_is_occupied(undo.captured) ? 1 : 0) - childValue;
+        game_unmake_move(&child, &undo);
+        if (!known) {
+            return false;
+        }
+        if (!found || gain > best) {
+            best = gain;
+            *outMove = moves[i];
+            found = true;
+        }
+    }
+    return found;
+}
+
+/*
+ * Lazy SMP: every thread runs the same iterative deepening from the same
+ * root, odd-numbered helpers one ply ahead, and they meet only through the
+ * transposition table. The deepest completed iteration of any thread wins
+ * (an interrupted one counts for slightly more than the iteration before
+ * it); ties go to whoever published first, so a single thread is
+ * deterministic. The caller does not search: it sleeps until the main
+ * thread returns or the reply is due, whichever comes first, and takes
+ * the best result published by then. The searchers stop AI_REPLY_LEAD_US
+ * before the reply so an interrupted iteration usually makes it in.
+ */
+static void alpha_beta_pick_move(AiInstance *ai, const GameState *state, Move *moves, size_t count,
+                                 const AiSearchLimits *limits, unsigned long long startUs, Move *outMove) {
+    SharedSearch *shared = &ai->alphaBetaSearch;
+    shared->ai = ai;
+    shared->root = *state;
+    tt_new_search(&ai->table);
+
+    TtEntry entry;
+    if (tt_probe(&ai->table, search_key(&shared->root), &entry) && entry.hasMove) {
+        move_to_front(moves, count, entry.bestMove);
+    }
+    for (size_t i = 0; i < count; ++i) {
+        shared->rootMoves[i] = moves[i];
+    }
+    shared->rootCount = count;
+    shared->maxDepth = (limits->maxDepth > 0 && limits->maxDepth < AI_MAX_DEPTH) ? limits->maxDepth : AI_MAX_DEPTH;
+    shared->maxNodes = limits->maxNodes;
+    shared->softDeadlineUs = deadline_after(startUs, limits->softTimeMs, 0);
+    unsigned long long replyDeadlineUs = deadline_after(startUs, limits->hardTimeMs, ai->stopMarginUs);
+    shared->hardDeadlineUs = deadline_after(startUs, limits->hardTimeMs, ai->stopMarginUs + AI_REPLY_LEAD_US);
+    shared->stopRequest = limits->stop;
+    shared->onInfo = limits->onInfo;
+    shared->infoUserData = limits->infoUserData;
+    shared->startUs = startUs;
+    atomic_init(&shared->stop, false);
+    atomic_init(&shared->nodes, 0);
+    pthread_mutex_init(&shared->resultLock, NULL);
+    init_finished_signal(&shared->finishedSignal);
+    shared->finished = false;
+    shared->replied = false;
+    shared->bestQuality = 0;
+    shared->bestMove = moves[0];
+    ai->alphaBetaActive = true;
+
+    for (int i = 0; i < ai->threadCount; ++i) {
+        HelperArgs *args = &ai->helperArgs[i];
+        args->shared = shared;
+        args->startDepth = 1 + (i % 2);
+        args->isMain = (i == 0);
+        if (pthread_create(&ai->helpers[ai->helperCount], NULL, helper_main, args) != 0) {
+            break;
+        }
+        ++ai->helperCount;
+    }
+    /* Without a main thread the caller has to search itself. */
+    if (ai->helperCount == 0) {
+        helper_main(&ai->helperArgs[0]);
+    }
+
+    pthread_mutex_lock(&shared->resultLock);
+    wait_for_search(&shared->finishedSignal, &shared->resultLock, &shared->finished, replyDeadlineUs);
+    shared->replied = true;
+    atomic_store_explicit(&shared->stop, true, memory_order_relaxed);
+    ai->lastStats.nodes = atomic_load_explicit(&shared->nodes, memory_order_relaxed);
+    ai->lastStats.depth = shared->bestQuality / 2;
+    *outMove = shared->bestMove;
+    pthread_mutex_unlock(&shared->resultLock);
+}
+
+/*
+ * Monte Carlo tree search. Every thread repeatedly walks down the shared
+ * tree by UCT, expands the node it stops at, plays uniformly random moves
+ * to the end of the game and adds the result along the path. Visits are
+ * counted on the way down, before the result is known, so a line another
+ * thread is busy with looks like a loss until its playout finishes
+ * (virtual loss) and the threads spread over different lines instead of
+ * piling onto one. Tree nodes come from per-thread arenas, released by
+ * whichever thread is last to stop using the tree once the move is chosen,
+ * so no tree is kept while the game waits for the next search.
+ */
+static void mcts_node_init(MctsNode *node, Move move) {
+    node->children = NULL;
+    atomic_init(&node->visits, 0);
+    atomic_init(&node->reward, 0);
+    atomic_init(&node->expansion, MCTS_LEAF);
+    node->childCount = 0;
+    node->move = move;
+}
+
+static MctsNode *arena_alloc(MctsArena *arena, size_t count) {
+    MctsBlock *block = arena->blocks;
+    if (!block || block->capacity - block->used < count) {
+        size_t capacity = count > MCTS_ARENA_BLOCK_NODES ? count : MCTS_ARENA_BLOCK_NODES;
+        block = malloc(sizeof(MctsBlock) + capacity * sizeof(MctsNode));
+        if (!block) {
+            return NULL;
+        }
+        block->next = arena->blocks;
+        block->used = 0;
+        block->capacity = capacity;
+        arena->blocks = block;
+    }
+    MctsNode *nodes = &block->nodes[block->used];
+    block->used += count;
+    return nodes;
+}
+
+static void arena_release(MctsArena *arena) {
+    MctsBlock *block = arena->blocks;
+    while (block) {
+        MctsBlock *next = block->next;
+        free(block);
+        block = next;
+    }
+    arena->blocks = NULL;
+}
+
+/* xorshift64*; each thread owns its generator. */
+static uint64_t mcts_random(uint64_t *rng) {
+    *rng ^= *rng >> 12;
+    *rng ^= *rng << 25;
+    *rng ^= *rng >> 27;
+    return *rng * 0x2545F4914F6CDD1DULL;
+}
+
+/*
+ * Only the thread that wins the compare-exchange builds the children; the
+ * others keep treating the node as a leaf until they are published. A node
+ * left in MCTS_EXPANDING (no moves, or the tree is at its size cap) stays a
+ * leaf for the rest of the search.
+ */
+static void mcts_expand(MctsWorker *worker, MctsNode *node, const GameState *state) {
+    int expected = MCTS_LEAF;
+    if (!atomic_compare_exchange_strong(&node->expansion, &expected, MCTS_EXPANDING)) {
+        return;
+    }
+
+    Move moves[MAX_MOVES_PER_TURN];
+    size_t count = game_list_moves(state, state->currentPlayer, moves, MAX_MOVES_PER_TURN);
+    if (count == 0) {
+        return;
+    }
+    unsigned long total = atomic_fetch_add_explicit(&worker->search->treeNodes, count, memory_order_relaxed) + count;
+    if (total > MCTS_MAX_TREE_NODES) {
+        return;
+    }
+    MctsNode *children = arena_alloc(&worker->arena, count);
+    if (!children) {
+        return;
+    }
+    for (size_t i = 0; i < count; ++i) {
+        mcts_node_init(&children[i], moves[i]);
+    }
+    node->children = children;
+    node->childCount = (unsigned int)count;
+    atomic_store_explicit(&node->expansion, MCTS_EXPANDED, memory_order_release);
+}
+
+/* UCT; an unvisited child is always tried before any visited one. */
+static MctsNode *mcts_select(MctsNode *node) {
+    double logParent = log((double)atomic_load_explicit(&node->visits, memory_order_relaxed) + 1.0);
+    MctsNode *best = &node->children[0];
+    double bestScore = -1.0;
+    for (unsigned int i = 0; i < node->childCount; ++i) {
+        MctsNode *child = &node->children[i];
+        unsigned int visits = atomic_load_explicit(&child->visits, memory_order_relaxed);
+        if (visits == 0) {
+            return child;
+        }
+        unsigned int reward = atomic_load_explicit(&child->reward, memory_order_relaxed);
+        double score = (double)reward / (2.0 * visits) + MCTS_EXPLORATION * sqrt(logParent / visits);
+        if (score > bestScore) {
+            bestScore = score;
+            best = child;
+        }
+    }
+    return best;
+}
+
+/* Plays random moves to the end; returns the winner, or PLAYER_COUNT for a draw. */
+static Player mcts_playout(MctsWorker *worker, GameState *state) {
+    while (!state->isGameOver) {
+        Move moves[MAX_MOVES_PER_TURN];
+        size_t count = game_list_moves(state, state->currentPlayer, moves, MAX_MOVES_PER_TURN);
+        if (count == 0) {
+            break;
+        }
+        Move move = moves[mcts_random(&worker->rng) % count];
+        game_apply_move(state, move.from, move.to);
+    }
+    if (state->score[PLAYER_WHITE] > state->score[PLAYER_BLACK]) {
+        return PLAYER_WHITE;
+    }
+    if (state->score[PLAYER_BLACK] > state->score[PLAYER_WHITE]) {
+        return PLAYER_BLACK;
+    }
+    return PLAYER_COUNT;
+}
+
+static void mcts_iterate(MctsWorker *worker) {
+    MctsSearch *search = worker->search;
+    GameState state = search->root;
+    MctsNode *path[MCTS_MAX_PATH];
+    Player movers[MCTS_MAX_PATH];
+    size_t length = 0;
+
+    MctsNode *node = &search->rootNode;
+    atomic_fetch_add_explicit(&node->visits, 1, memory_order_relaxed);
+    while (length < MCTS_MAX_PATH &&
+           atomic_load_explicit(&node->expansion, memory_order_acquire) == MCTS_EXPANDED) {
+        Player mover = state.currentPlayer;
+        node = mcts_select(node);
+        atomic_fetch_add_explicit(&node->visits, 1, memory_order_relaxed);
+        game_apply_move(&state, node->move.from, node->move.to);
+        path[length] = node;
+        movers[length] = mover;
+        ++length;
+    }
+    if (!state.isGameOver && atomic_load_explicit(&node->visits, memory_order_relaxed) >= MCTS_EXPAND_VISITS) {
+        mcts_expand(worker, node, &state);
+    }
+
+    Player winner = mcts_playout(worker, &state);
+    for (size_t i = 0; i < length; ++i) {
+        unsigned int reward = (winner == PLAYER_COUNT) ? 1 : (movers[i] == winner ? 2 : 0);
+        if (reward) {
+            atomic_fetch_add_explicit(&path[i]->reward, reward, memory_order_relaxed);
+        }
+    }
+}
+
+static bool mcts_should_stop(MctsWorker *worker) {
+    MctsSearch *search = worker->search;
+    if (atomic_load_explicit(&search->stop, memory_order_relaxed)) {
+        return true;
+    }
+    unsigned long playouts = atomic_fetch_add_explicit(&search->playouts, 1, memory_order_relaxed);
+    bool stop = (search->maxPlayouts && playouts >= search->maxPlayouts) ||
+                (search->stopRequest && atomic_load_explicit(search->stopRequest, memory_order_relaxed));
+    /* A playout costs far more than reading the clock, so check it every time. */
+    if (!stop && search->deadlineUs) {
+        stop = now_us() >= search->deadlineUs;
+    }
+    if (stop) {
+        atomic_store_explicit(&search->stop, true, memory_order_relaxed);
+    }
+    return stop;
+}
+
+static void mcts_run(MctsWorker *worker) {
+    while (!mcts_should_stop(worker)) {
+        mcts_iterate(worker);
+    }
+}
+
+static void mcts_release_arenas(AiInstance *ai) {
+    for (int i = 0; i < ai->mctsWorkerCount; ++i) {
+        arena_release(&ai->mctsWorkers[i].arena);
+    }
+    ai->mctsWorkerCount = 0;
+}
+
+/* Whoever stops using the tree last, caller or worker, frees it. */
+static void mcts_leave(MctsSearch *search) {
+    if (atomic_fetch_sub_explicit(&search->participants, 1, memory_order_acq_rel) == 1) {
+        mcts_release_arenas(search->ai);
+    }
+}
+
+static void *mcts_worker_main(void *arg) {
+    MctsWorker *worker = arg;
+    MctsSearch *search = worker->search;
+    mcts_run(worker);
+    pthread_mutex_lock(&search->finishLock);
+    search->finished = true;
+    pthread_cond_signal(&search->finishedSignal);
+    pthread_mutex_unlock(&search->finishLock);
+    mcts_leave(search);
+    return NULL;
+}
+
+/*
+ * Fails only if the root could not be expanded (out of memory). As with
+ * alpha-beta the caller only waits: it replies once a worker stops or the
+ * reply is due, and never waits for the workers to finish their playouts.
+ */
+static bool mcts_pick_move(AiInstance *ai, const GameState *state, const AiSearchLimits *limits, unsigned long long startUs,
+                           Move *outMove) {
+    MctsSearch *search = &ai->mctsSearch;
+    search->ai = ai;
+    search->root = *state;
+    search->root.isPaused = false;
+    mcts_node_init(&search->rootNode, (Move){ { 0, 0 }, { 0, 0 } });
+    search->maxPlayouts = limits->maxNodes;
+    search->stopRequest = limits->stop;
+    /* Without a time or playout limit the search would never end. */
+    unsigned int timeMs = (limits->hardTimeMs || limits->maxNodes) ? limits->hardTimeMs : AI_DEFAULT_TIME_MS;
+    unsigned long long replyDeadlineUs = deadline_after(startUs, timeMs, ai->stopMarginUs);
+    search->deadlineUs = deadline_after(startUs, timeMs, ai->stopMarginUs + AI_REPLY_LEAD_US);
+    atomic_init(&search->stop, false);
+    atomic_init(&search->playouts, 0);
+    atomic_init(&search->treeNodes, 0);
+    atomic_init(&search->participants, 1);
+
+    MctsWorker *workers = ai->mctsWorkers;
+    for (int i = 0; i < ai->threadCount; ++i) {
+        workers[i].search = search;
+        workers[i].arena.blocks = NULL;
+        workers[i].rng = (state->hash ^ ((uint64_t)(i + 1) * 0x9E3779B97F4A7C15ULL)) | 1;
+    }
+    ai->mctsWorkerCount = ai->threadCount;
+    /* The root is expanded up front so the threads start spread over its moves. */
+    mcts_expand(&workers[0], &search->rootNode, &search->root);
+    if (atomic_load_explicit(&search->rootNode.expansion, memory_order_relaxed) != MCTS_EXPANDED) {
+        mcts_release_arenas(ai);
+        return false;
+    }
+
+    pthread_mutex_init(&search->finishLock, NULL);
+    init_finished_signal(&search->finishedSignal);
+    search->finished = false;
+    ai->mctsActive = true;
+    for (int i = 0; i < ai->threadCount; ++i) {
+        atomic_fetch_add_explicit(&search->participants, 1, memory_order_relaxed);
+        if (pthread_create(&ai->helpers[ai->helperCount], NULL, mcts_worker_main, &workers[i]) != 0) {
+            atomic_fetch_sub_explicit(&search->participants, 1, memory_order_relaxed);
+            break;
+        }
+        ++ai->helperCount;
+    }
+    /* Without any worker thread the caller has to search itself. */
+    if (ai->helperCount == 0) {
+        mcts_run(&workers[0]);
+        search->finished = true;
+    }
+
+    pthread_mutex_lock(&search->finishLock);
+    wait_for_search(&search->finishedSignal, &search->finishLock, &search->finished, replyDeadlineUs);
+    pthread_mutex_unlock(&search->finishLock);
+    atomic_store_explicit(&search->stop, true, memory_order_relaxed);
+
+    /* The most visited move is the most reliable one. */
+    const MctsNode *root = &search->rootNode;
+    unsigned int bestVisits = 0;
+    *outMove = root->children[0].move;
+    for (unsigned int i = 0; i < root->childCount; ++i) {
+        unsigned int visits = atomic_load_explicit(&root->children[i].visits, memory_order_relaxed);
+        if (visits > bestVisits) {
+            bestVisits = visits;
+            *outMove = root->children[i].move;
+        }
+    }
+
+    ai->lastStats.nodes = atomic_load_explicit(&search->playouts, memory_order_relaxed);
+    ai->lastStats.depth = 0;
+    mcts_leave(search);
+    return true;
+}
+
+/*
+ * Search threads are told to stop when a search replies but are only
+ * joined here, at the start of the next search or on shutdown, so a thread
+ * that is slow to get scheduled on a busy machine never delays the reply.
+ * Until then they may still touch the search state and the hash table,
+ * which is why those live in the instance; the last MCTS thread out frees
+ * its tree without waiting for this.
+ */
+static void finish_previous_search(AiInstance *ai) {
+    for (int i = 0; i < ai->helperCount; ++i) {
+        pthread_join(ai->helpers[i], NULL);
+    }
+    ai->helperCount = 0;
+
+    if (ai->alphaBetaActive) {
+        pthread_cond_destroy(&ai->alphaBetaSearch.finishedSignal);
+        pthread_mutex_destroy(&ai->alphaBetaSearch.resultLock);
+        ai->alphaBetaActive = false;
+    }
+    if (ai->mctsActive) {
+        pthread_cond_destroy(&ai->mctsSearch.finishedSignal);
+        pthread_mutex_destroy(&ai->mctsSearch.finishLock);
+        ai->mctsActive = false;
+    }
+}
+
+/*
+ * The caller replies at the hard limit minus stopMarginUs. It only has to
+ * wake from a timed wait, but on a loaded machine even that can take a few
+ * milliseconds, so after every search that ran into the deadline the
+ * margin is raised to cover the delay actually seen, then allowed to shrink
+ * slowly back towards AI_MIN_STOP_MARGIN_US while the machine is quiet.
+ */
+static void learn_stop_margin(AiInstance *ai, unsigned long long startUs, unsigned int hardTimeMs) {
+    unsigned long long deadlineUs = deadline_after(startUs, hardTimeMs, ai->stopMarginUs);
+    unsigned long long nowUs = now_us();
+    if (!deadlineUs || nowUs < deadlineUs) {
+        return;
+    }
+
+    unsigned long long delayUs = nowUs - deadlineUs;
+    unsigned long long capUs = (unsigned long long)hardTimeMs * 1000ULL / 2;
+    if (delayUs > ai->stopMarginUs) {
+        ai->stopMarginUs = delayUs + AI_MIN_STOP_MARGIN_US;
+    } else {
+        ai->stopMarginUs -= (ai->stopMarginUs - delayUs) / 64;
+    }
+    if (ai->stopMarginUs > capUs) {
+        ai->stopMarginUs = capUs;
+    }
+    if (ai->stopMarginUs < AI_MIN_STOP_MARGIN_US) {
+        ai->stopMarginUs = AI_MIN_STOP_MARGIN_US;
+    }
+}
+
+bool ai_instance_pick_move(AiInstance *ai, const GameState *state, const AiSearchLimits *limits, Move *outMove) {
+    unsigned long long startUs = now_us();
+    if (!ai || !state || !outMove) {
+        return false;
+    }
+    AiSearchLimits defaults;
+    if (!limits) {
+        ai_default_limits(&defaults);
+        limits = &defaults;
+    }
+
+    finish_previous_search(ai);
+    ai->lastStats.nodes = 0;
+    ai->lastStats.depth = 0;
 
     Move moves[MAX_MOVES_PER_TURN];
     size_t count = game_list_moves(state, state->currentPlayer, moves, MAX_MOVES_PER_TURN);
     if (count == 0) {
         return false;
     }
+    if (count == 1) {
+        *outMove = moves[0];
+        return true;
+    }
+    if (pick_solved_move(ai, state, moves, count, outMove)) {
+        return true;
+    }
 
-    size_t index = (size_t)(rand() % count);
-    *outMove = moves[index];
+    if (ai->engine != AI_ENGINE_MCTS || !mcts_pick_move(ai, state, limits, startUs, outMove)) {
+        alpha_beta_pick_move(ai, state, moves, count, limits, startUs, outMove);
+    }
+    learn_stop_margin(ai, startUs, limits->hardTimeMs);
     return true;
 }
+
+bool ai_pick_move(const GameState *state, const AiSearchLimits *limits, Move *outMove) {
+    return ai_instance_pick_move(&defaultInstance, state, limits, outMove);
+}
@@ -0,0 +1,337 @@
+#include "ai_worker.h"
+
+#include <string.h>
+
+static void push_result(AiWorker *worker, const AiWorkerResult *result) {
+    if (worker->queueCount >= AI_WORKER_QUEUE_SIZE) {
+        worker->queueHead = (worker->queueHead + 1) % AI_WORKER_QUEUE_SIZE;
+        --worker->queueCount;
+    }
+    size_t tail = (worker->queueHead + worker->queueCount) % AI_WORKER_QUEUE_SIZE;
+    worker->queue[tail] = *result;
+    ++worker->queueCount;
+}
+
+static AiPositionKey position_key(const GameState *state) {
+    AiPositionKey key;
+    key.hash = state->hash;
+    key.occupancy[PLAYER_WHITE] = state->occupancy[PLAYER_WHITE];
+    key.occupancy[PLAYER_BLACK] = state->occupancy[PLAYER_BLACK];
+    key.score[PLAYER_WHITE] = state->score[PLAYER_WHITE];
+    key.score[PLAYER_BLACK] = state->score[PLAYER_BLACK];
+    return key;
+}
+
+static bool same_position(const AiPositionKey *a, const AiPositionKey *b) {
+    return a->hash == b->hash && a->occupancy[PLAYER_WHITE] == b->occupancy[PLAYER_WHITE] &&
+           a->occupancy[PLAYER_BLACK] == b->occupancy[PLAYER_BLACK] &&
+           a->score[PLAYER_WHITE] == b->score[PLAYER_WHITE] && a->score[PLAYER_BLACK] == b->score[PLAYER_BLACK];
+}
+
+/* Pondered answers only stand in for a request made with the same budget. */
+static bool same_limits(const AiSearchLimits *a, const AiSearchLimits *b) {
+    return a->maxDepth == b->maxDepth && a->maxNodes == b->maxNodes &&
+           a->softTimeMs == b->softTimeMs && a->hardTimeMs == b->hardTimeMs;
+}
+
+static void clear_ponder(AiWorker *worker) {
+    worker->hasPonderJob = false;
+    worker->hasPonderRoot = false;
+    worker->adoptJobId = 0;
+    worker->ponderResultCount = 0;
+    if (worker->pondering) {
+        atomic_store(&worker->cancel, true);
+    }
+}
+
+/* Puts the predicted reply first, then captures, keeping generator order otherwise. */
+static size_t order_replies(const GameState *root, Move predicted, bool hasPrediction, Move *replies, size_t count) {
+    Move ordered[MAX_MOVES_PER_TURN];
+    size_t orderedCount = 0;
+    Player opponent = game_get_opponent(root->currentPlayer);
+    for (int pass = 0; pass < 3; ++pass) {
+        for (size_t i = 0; i < count; ++i) {
+            bool isPredicted = hasPrediction && replies[i].from.row == predicted.from.row &&
+                               replies[i].from.col == predicted.from.col &&
+                               replies[i].to.row == predicted.to.row && replies[i].to.col == predicted.to.col;
+            Square target = root->board[replies[i].to.row][replies[i].to.col];
+            bool isCapture = square_is_occupied(target) && square_owner(target) == opponent;
+            int rank = isPredicted ? 0 : (isCapture ? 1 : 2);
+            if (rank == pass) {
+                ordered[orderedCount++] = replies[i];
+            }
+        }
+    }
+    memcpy(replies, ordered, orderedCount * sizeof(Move));
+    return orderedCount;
+}
+
+/*
+ * Searches the positions after the human's likeliest replies, best guess
+ * first. Each search gets the limits a real request would, so a hit costs
+ * no extra strength budget; it just started earlier. Misses still leave
+ * the shared hash table warm. Called and returns with the lock released.
+ */
+static void ponder(AiWorker *worker, const GameState *root, const AiSearchLimits *limits) {
+    Move replies[MAX_MOVES_PER_TURN];
+    size_t count = game_list_moves(root, root->currentPlayer, replies, MAX_MOVES_PER_TURN);
+    if (count == 0) {
+        return;
+    }
+
+    Move predicted;
+    bool hasPrediction = count > 1 && ai_pick_move(root, limits, &predicted);
+    count = order_replies(root, predicted, hasPrediction, replies, count);
+    if (count > AI_WORKER_PONDER_REPLIES) {
+        count = AI_WORKER_PONDER_REPLIES;
+    }
+
+    for (size_t i = 0; i < count; ++i) {
+        GameState position = *root;
+        MoveUndo undo;
+        if (!game_make_move(&position, replies[i], &undo) || position.isGameOver) {
+            continue;
+        }
+
+        AiPonderResult result;
+        result.key = position_key(&position);
+        pthread_mutex_lock(&worker->lock);
+        if (atomic_load(&worker->cancel)) {
+            pthread_mutex_unlock(&worker->lock);
+            return;
+        }
+        worker->ponderTarget = result.key;
+        worker->hasPonderTarget = true;
+        pthread_mutex_unlock(&worker->lock);
+
+        result.hasMove = ai_pick_move(&position, limits, &result.move);
+
+        pthread_mutex_lock(&worker->lock);
+        worker->hasPonderTarget = false;
+        bool stop = atomic_load(&worker->cancel);
+        if (!stop && worker->adoptJobId != 0) {
+            AiWorkerResult adopted = { worker->adoptJobId, result.hasMove, result.move };
+            push_result(worker, &adopted);
+            worker->adoptJobId = 0;
+            stop = true;
+        } else if (!stop && worker->ponderResultCount < AI_WORKER_PONDER_REPLIES) {
+            worker->ponderResults[worker->ponderResultCount++] = result;
+        }
+        pthread_mutex_unlock(&worker->lock);
+        if (stop) {
+            return;
+        }
+    }
+}
+
+static void *worker_main(void *arg) {
+    AiWorker *worker = arg;
+
+    pthread_mutex_lock(&worker->lock);
+    for (;;) {
+        while (!worker->hasJob && !worker->hasPonderJob && !worker->shuttingDown) {
+            pthread_cond_wait(&worker->wake, &worker->lock);
+        }
+        if (worker->shuttingDown) {
+            break;
+        }
+
+        if (!worker->hasJob) {
+            GameState root = worker->ponderRoot;
+            AiSearchLimits limits = worker->ponderLimits;
+            limits.stop = &worker->cancel;
+            worker->hasPonderJob = false;
+            worker->pondering = true;
+            atomic_store(&worker->cancel, false);
+            pthread_mutex_unlock(&worker->lock);
+
+            ponder(worker, &root, &limits);
+
+            pthread_mutex_lock(&worker->lock);
+            worker->pondering = false;
+            worker->hasPonderTarget = false;
+            worker->adoptJobId = 0;
+            continue;
+        }
+
+        GameState snapshot = worker->snapshot;
+        AiSearchLimits limits = worker->limits;
+        limits.stop = &worker->cancel;
+        AiWorkerResult result = { worker->snapshotJobId, false, { { 0, 0 }, { 0, 0 } } };
+        worker->hasJob = false;
+        worker->busy = true;
+        atomic_store(&worker->cancel, false);
+        pthread_mutex_unlock(&worker->lock);
+
+        result.hasMove = ai_pick_move(&snapshot, &limits, &result.move);
+
+        pthread_mutex_lock(&worker->lock);
+        worker->busy = false;
+        if (!atomic_load(&worker->cancel)) {
+            push_result(worker, &result);
+        }
+    }
+    pthread_mutex_unlock(&worker->lock);
+    return NULL;
+}
+
+bool ai_worker_start(AiWorker *worker) {
+    if (!worker) {
+        return false;
+    }
+
+    memset(worker, 0, sizeof(*worker));
+    atomic_init(&worker->cancel, false);
+    if (pthread_mutex_init(&worker->lock, NULL) != 0) {
+        return false;
+    }
+    if (pthread_cond_init(&worker->wake, NULL) != 0) {
+        pthread_mutex_destroy(&worker->lock);
+        return false;
+    }
+    if (pthread_create(&worker->thread, NULL, worker_main, worker) != 0) {
+        pthread_cond_destroy(&worker->wake);
+        pthread_mutex_destroy(&worker->lock);
+        return false;
+    }
+    worker->started = true;
+    return true;
+}
+
+void ai_worker_stop(AiWorker *worker) {
+    if (!worker || !worker->started) {
+        return;
+    }
+
+    pthread_mutex_lock(&worker->lock);
+    worker->shuttingDown = true;
+    atomic_store(&worker->cancel, true);
+    pthread_cond_signal(&worker->wake);
+    pthread_mutex_unlock(&worker->lock);
+
+    pthread_join(worker->thread, NULL);
+    pthread_cond_destroy(&worker->wake);
+    pthread_mutex_destroy(&worker->lock);
+    worker->started = false;
+}
+
+/*
+ * Queues a search of `snapshot`, replacing any search still in progress.
+ * A position the worker already pondered is answered at once, and one it
+ * is pondering right now takes over that search.
+ */
+unsigned int ai_worker_request(AiWorker *worker, const GameState *snapshot, const AiSearchLimits *limits) {
+    if (!worker || !worker->started || !snapshot) {
+        return 0;
+    }
+
+    AiSearchLimits requestLimits;
+    if (limits) {
+        requestLimits = *limits;
+    } else {
+        ai_default_limits(&requestLimits);
+    }
+    AiPositionKey key = position_key(snapshot);
+
+    pthread_mutex_lock(&worker->lock);
+    unsigned int jobId = ++worker->nextJobId;
+    bool pondered = worker->hasPonderRoot && same_limits(&worker->ponderLimits, &requestLimits);
+    const AiPonderResult *hit = NULL;
+    for (size_t i = 0; pondered && i < worker->ponderResultCount; ++i) {
+        if (same_position(&worker->ponderResults[i].key, &key)) {
+            hit = &worker->ponderResults[i];
+            break;
+        }
+    }
+
+    if (hit) {
+        AiWorkerResult result = { jobId, hit->hasMove, hit->move };
+        push_result(worker, &result);
+        clear_ponder(worker);
+    } else if (pondered && worker->pondering && worker->hasPonderTarget && same_position(&worker->ponderTarget, &key)) {
+        worker->adoptJobId = jobId;
+        worker->hasPonderRoot = false;
+        worker->ponderResultCount = 0;
+    } else {
+        clear_ponder(worker);
+        if (worker->busy) {
+            atomic_store(&worker->cancel, true);
+        }
+        worker->snapshot = *snapshot;
+        worker->limits = requestLimits;
+        worker->snapshotJobId = jobId;
+        worker->hasJob = true;
+        pthread_cond_signal(&worker->wake);
+    }
+    pthread_mutex_unlock(&worker->lock);
+    return jobId;
+}
+
+void ai_worker_ponder(AiWorker *worker, const GameState *snapshot, const AiSearchLimits *limits) {
+    if (!worker || !worker->started || !snapshot) {
+        return;
+    }
+
+    AiPositionKey key = position_key(snapshot);
+    pthread_mutex_lock(&worker->lock);
+    bool searching = worker->hasJob || worker->busy || worker->adoptJobId != 0;
+    bool repeated = worker->hasPonderRoot && same_position(&worker->ponderRootKey, &key);
+    if (!searching && !repeated) {
+        clear_ponder(worker);
+        worker->ponderRoot = *snapshot;
+        if (limits) {
+            worker->ponderLimits = *limits;
+        } else {
+            ai_default_limits(&worker->ponderLimits);
+        }
+        worker->ponderRootKey = key;
+        worker->hasPonderRoot = true;
+        worker->hasPonderJob = true;
+        pthread_cond_signal(&worker->wake);
+    }
+    pthread_mutex_unlock(&worker->lock);
+}
+
+void ai_worker_cancel(AiWorker *worker) {
+    if (!worker || !worker->started) {
+        return;
+    }
+
+    pthread_mutex_lock(&worker->lock);
+    worker->hasJob = false;
+    if (worker->busy) {
+        atomic_store(&worker->cancel, true);
+    }
+    clear_ponder(worker);
+    worker->queueHead = 0;
+    worker->queueCount = 0;
+    pthread_mutex_unlock(&worker->lock);
+}
+
+/* True while a search is queued, running, or waiting to be polled; pondering alone does not count. */
+bool ai_worker_pending(AiWorker *worker) {
+    if (!worker || !worker->started) {
+        return false;
+    }
+
+    pthread_mutex_lock(&worker->lock);
+    bool pending = worker->hasJob || worker->busy || worker->adoptJobId != 0 || worker->queueCount > 0;
+    pthread_mutex_unlock(&worker->lock);
+    return pending;
+}
+
+bool ai_worker_poll(AiWorker *worker, AiWorkerResult *outResult) {
+    if (!worker || !worker->started || !outResult) {
+        return false;
+    }
+
+    pthread_mutex_lock(&worker->lock);
+    bool hasResult = worker->queueCount > 0;
+    if (hasResult) {
+        *outResult = worker->queue[worker->queueHead];
+        worker->queueHead = (worker->queueHead + 1) % AI_WORKER_QUEUE_SIZE;
+        --worker->queueCount;
+    }
+    pthread_mutex_unlock(&worker->lock);
+    return hasResult;
+}
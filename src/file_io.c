@@ -54,14 +54,14 @@ bool save_game_to_path(const GameState* state, const ChatLog* log, const char* p
 
     for (int r = 0; r < BOARD_SIZE; r++) {
         for (int c = 0; c < BOARD_SIZE; c++) {
-            const Square* sq = &state->board[r][c];
-            if (!sq->occupied) {
+            Square sq = state->board[r][c];
+            if (!square_is_occupied(sq)) {
                 fprintf(f, "__ ");
             }
             else {
                 fprintf(f, "%c%c ",
-                    piece_to_char(sq->type),
-                    sq->owner == PLAYER_WHITE ? 'W' : 'B');
+                    piece_to_char(square_type(sq)),
+                    square_owner(sq) == PLAYER_WHITE ? 'W' : 'B');
             }
         }
         fprintf(f, "\n");
@@ -107,49 +107,78 @@ bool load_game_from_path(GameState* state, ChatLog* log, const char* path) {
     FILE* f = fopen(path, "r");
     if (!f) return false;
 
+    bool loaded = load_game_from_stream(state, log, f);
+    fclose(f);
+    return loaded;
+}
+
+bool load_game_from_stream(GameState* state, ChatLog* log, FILE* f) {
+    if (!state || !f) return false;
+
     char header[64];
-    if (!fgets(header, sizeof(header), f)) { fclose(f); return false; }
+    if (!fgets(header, sizeof(header), f)) return false;
     header[strcspn(header, "\r\n")] = 0;
 
     if (strcmp(header, SAVE_HEADER) != 0) {
-        fclose(f);
         return false;
     }
 
-    int paused, gameOver;
-    fscanf(f, "%d %d %d %d %d %d\n",
-        (int*)&state->mode,
-        (int*)&state->currentPlayer,
-        &state->score[0],
-        &state->score[1],
-        &paused,
-        &gameOver);
+    /*
+     * The stream may come from a protocol client, so every field is checked
+     * before use. The save is parsed into a local state and only copied over
+     * the caller's game once all of it is valid.
+     */
+    int mode, player, paused, gameOver;
+    int scores[PLAYER_COUNT];
+    if (fscanf(f, "%d %d %d %d %d %d\n", &mode, &player, &scores[0], &scores[1], &paused, &gameOver) != 6) {
+        return false;
+    }
+    if (mode != MODE_NONE && mode != MODE_PVE && mode != MODE_PVP) {
+        return false;
+    }
+    if (player != PLAYER_WHITE && player != PLAYER_BLACK) {
+        return false;
+    }
+    /* A point is scored per capture and each side has one piece per type. */
+    for (int p = 0; p < PLAYER_COUNT; p++) {
+        if (scores[p] < 0 || scores[p] > PIECE_TYPE_COUNT) {
+            return false;
+        }
+    }
 
-    state->isPaused = paused != 0;
-    state->isGameOver = gameOver != 0;
+    GameState loaded;
+    memset(&loaded, 0, sizeof(loaded));
+    loaded.mode = (GameMode)mode;
+    loaded.currentPlayer = (Player)player;
+    loaded.score[0] = scores[0];
+    loaded.score[1] = scores[1];
+    loaded.isPaused = paused != 0;
+    loaded.isGameOver = gameOver != 0;
 
     for (int r = 0; r < BOARD_SIZE; r++) {
         for (int c = 0; c < BOARD_SIZE; c++) {
             char tok[4];
-            fscanf(f, "%3s", tok);
+            if (fscanf(f, "%3s", tok) != 1) {
+                return false;
+            }
 
-            Square* sq = &state->board[r][c];
+            Square* sq = &loaded.board[r][c];
             if (strcmp(tok, "__") == 0) {
-                sq->occupied = false;
+                *sq = SQUARE_EMPTY;
             }
             else {
                 PieceType pt;
-                if (!char_to_piece(tok[0], &pt)) {
-                    fclose(f);
+                if (!char_to_piece(tok[0], &pt) || (tok[1] != 'W' && tok[1] != 'B')) {
                     return false;
                 }
-                sq->occupied = true;
-                sq->type = pt;
-                sq->owner = (tok[1] == 'W') ? PLAYER_WHITE : PLAYER_BLACK;
+                *sq = square_make((tok[1] == 'W') ? PLAYER_WHITE : PLAYER_BLACK, pt);
             }
         }
     }
 
-    fclose(f);
+    if (!game_sync_board(&loaded)) {
+        return false;
+    }
+    *state = loaded;
     return true;
 }
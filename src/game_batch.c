@@ -0,0 +1,432 @@
+#include "game_batch.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define GAME_BATCH_X86 1
+#include <immintrin.h>
+#endif
+
+#define FILE_A_MASK 0x0101010101010101ULL
+#define FILE_H_MASK 0x8080808080808080ULL
+#define BATCH_ALIGNMENT 64
+
+static void *alloc_array(size_t capacity, size_t elementSize) {
+    void *array = aligned_alloc(BATCH_ALIGNMENT, capacity * elementSize);
+    if (array) {
+        memset(array, 0, capacity * elementSize);
+    }
+    return array;
+}
+
+bool game_batch_init(GameBatch *batch, size_t capacity) {
+    if (!batch || capacity == 0) {
+        return false;
+    }
+    memset(batch, 0, sizeof(*batch));
+    /* Keeps every array size a multiple of the alignment, as aligned_alloc requires. */
+    capacity = (capacity + BATCH_ALIGNMENT - 1) / BATCH_ALIGNMENT * BATCH_ALIGNMENT;
+
+    bool ok = true;
+    for (int p = 0; p < PLAYER_COUNT; ++p) {
+        ok = ok && (batch->occupancy[p] = alloc_array(capacity, sizeof(Bitboard))) != NULL;
+        ok = ok && (batch->score[p] = alloc_array(capacity, sizeof(int32_t))) != NULL;
+    }
+    for (int t = 0; t < PIECE_TYPE_COUNT; ++t) {
+        ok = ok && (batch->pieces[t] = alloc_array(capacity, sizeof(Bitboard))) != NULL;
+    }
+    for (int d = 0; d < 3; ++d) {
+        ok = ok && (batch->targets[d] = alloc_array(capacity, sizeof(Bitboard))) != NULL;
+    }
+    ok = ok && (batch->currentPlayer = alloc_array(capacity, sizeof(uint8_t))) != NULL;
+    ok = ok && (batch->isGameOver = alloc_array(capacity, sizeof(uint8_t))) != NULL;
+    if (!ok) {
+        game_batch_free(batch);
+        return false;
+    }
+    batch->capacity = capacity;
+    batch->kernel = game_batch_kernel_supported(GAME_BATCH_AVX2) ? GAME_BATCH_AVX2
+                  : game_batch_kernel_supported(GAME_BATCH_SSE2) ? GAME_BATCH_SSE2
+                  : GAME_BATCH_SCALAR;
+    return true;
+}
+
+/* __builtin_cpu_supports also checks that the OS saves the AVX registers. */
+bool game_batch_kernel_supported(GameBatchKernel kernel) {
+    switch (kernel) {
+        case GAME_BATCH_SCALAR:
+            return true;
+#ifdef GAME_BATCH_X86
+        case GAME_BATCH_SSE2:
+            return true;
+        case GAME_BATCH_AVX2:
+            return __builtin_cpu_supports("avx2");
+#endif
+        default:
+            return false;
+    }
+}
+
+const char *game_batch_kernel_name(GameBatchKernel kernel) {
+    switch (kernel) {
+        case GAME_BATCH_SCALAR:
+            return "scalar";
+        case GAME_BATCH_SSE2:
+            return "sse2";
+        case GAME_BATCH_AVX2:
+            return "avx2";
+        default:
+            return "unknown";
+    }
+}
+
+bool game_batch_set_kernel(GameBatch *batch, GameBatchKernel kernel) {
+    if (!batch || !game_batch_kernel_supported(kernel)) {
+        return false;
+    }
+    batch->kernel = kernel;
+    return true;
+}
+
+void game_batch_free(GameBatch *batch) {
+    if (!batch) {
+        return;
+    }
+    for (int p = 0; p < PLAYER_COUNT; ++p) {
+        free(batch->occupancy[p]);
+        free(batch->score[p]);
+    }
+    for (int t = 0; t < PIECE_TYPE_COUNT; ++t) {
+        free(batch->pieces[t]);
+    }
+    for (int d = 0; d < 3; ++d) {
+        free(batch->targets[d]);
+    }
+    free(batch->currentPlayer);
+    free(batch->isGameOver);
+    memset(batch, 0, sizeof(*batch));
+}
+
+void game_batch_reset(GameBatch *batch, size_t count) {
+    if (!batch || !batch->capacity) {
+        return;
+    }
+    GameState start;
+    game_init(&start, MODE_NONE);
+    batch->count = (count < batch->capacity) ? count : batch->capacity;
+    for (size_t i = 0; i < batch->count; ++i) {
+        game_batch_set(batch, i, &start);
+    }
+    game_batch_generate(batch);
+}
+
+bool game_batch_set(GameBatch *batch, size_t index, const GameState *state) {
+    if (!batch || !state || index >= batch->capacity) {
+        return false;
+    }
+    for (int p = 0; p < PLAYER_COUNT; ++p) {
+        batch->occupancy[p][index] = state->occupancy[p];
+        batch->score[p][index] = state->score[p];
+    }
+    for (int t = 0; t < PIECE_TYPE_COUNT; ++t) {
+        batch->pieces[t][index] = state->pieces[t];
+    }
+    batch->currentPlayer[index] = (uint8_t)state->currentPlayer;
+    batch->isGameOver[index] = state->isGameOver;
+    if (index >= batch->count) {
+        batch->count = index + 1;
+    }
+    return true;
+}
+
+void game_batch_get(const GameBatch *batch, size_t index, GameState *state) {
+    if (!batch || !state || index >= batch->count) {
+        return;
+    }
+    game_reset(state, MODE_NONE);
+    for (int row = 0; row < BOARD_SIZE; ++row) {
+        for (int col = 0; col < BOARD_SIZE; ++col) {
+            Bitboard bit = (Bitboard)1 << (row * BOARD_SIZE + col);
+            if (!((batch->occupancy[PLAYER_WHITE][index] | batch->occupancy[PLAYER_BLACK][index]) & bit)) {
+                state->board[row][col] = SQUARE_EMPTY;
+                continue;
+            }
+            PieceType type = PIECE_ROOK;
+            for (int t = 0; t < PIECE_TYPE_COUNT; ++t) {
+                if (batch->pieces[t][index] & bit) {
+                    type = (PieceType)t;
+                }
+            }
+            Player owner = (batch->occupancy[PLAYER_BLACK][index] & bit) ? PLAYER_BLACK : PLAYER_WHITE;
+            state->board[row][col] = square_make(owner, type);
+        }
+    }
+    state->currentPlayer = (Player)batch->currentPlayer[index];
+    state->score[PLAYER_WHITE] = batch->score[PLAYER_WHITE][index];
+    state->score[PLAYER_BLACK] = batch->score[PLAYER_BLACK][index];
+    state->isGameOver = batch->isGameOver[index] != 0;
+    game_sync_board(state);
+}
+
+/*
+ * Both sides' shifts are computed and the mover's picked with a mask, so
+ * the loop body has no branches and vectorises (the arrays never overlap,
+ * hence restrict). A game with no targets is over; a game already over
+ * stays over.
+ */
+static void generate_targets_scalar(const Bitboard *restrict white, const Bitboard *restrict black,
+                             const uint8_t *restrict mover, Bitboard *restrict left, Bitboard *restrict straight,
+                             Bitboard *restrict right, uint8_t *restrict over, size_t count) {
+    for (size_t i = 0; i < count; ++i) {
+        Bitboard blackToMove = (Bitboard)0 - (Bitboard)mover[i];
+        Bitboard own = (white[i] & ~blackToMove) | (black[i] & blackToMove);
+        Bitboard empty = ~(white[i] | black[i]);
+        Bitboard notLeftEdge = own & ~FILE_A_MASK;
+        Bitboard notRightEdge = own & ~FILE_H_MASK;
+
+        Bitboard toLeft = (((notLeftEdge >> 9) & ~blackToMove) | ((notLeftEdge << 7) & blackToMove)) & ~own;
+        Bitboard toStraight = (((own >> 8) & ~blackToMove) | ((own << 8) & blackToMove)) & empty;
+        Bitboard toRight = (((notRightEdge >> 7) & ~blackToMove) | ((notRightEdge << 9) & blackToMove)) & ~own;
+        left[i] = toLeft;
+        straight[i] = toStraight;
+        right[i] = toRight;
+        /* Top bit of x | -x is set unless x == 0; a compare here would stop vectorisation. */
+        Bitboard any = toLeft | toStraight | toRight;
+        over[i] = (uint8_t)(over[i] | (uint8_t)(((any | (0 - any)) >> 63) ^ 1));
+    }
+}
+
+#ifdef GAME_BATCH_X86
+/*
+ * The scalar loop by hand, two games per iteration. SSE2 has no 64-bit
+ * compare, so a lane is zero when both of its 32-bit halves are. The
+ * arrays are 64-byte aligned and i is even, so the loads are aligned.
+ */
+static void generate_targets_sse2(const Bitboard *restrict white, const Bitboard *restrict black,
+                                  const uint8_t *restrict mover, Bitboard *restrict left, Bitboard *restrict straight,
+                                  Bitboard *restrict right, uint8_t *restrict over, size_t count) {
+    const __m128i fileA = _mm_set1_epi64x((long long)FILE_A_MASK);
+    const __m128i fileH = _mm_set1_epi64x((long long)FILE_H_MASK);
+    const __m128i zero = _mm_setzero_si128();
+    size_t i = 0;
+    for (; i + 2 <= count; i += 2) {
+        __m128i w = _mm_load_si128((const __m128i *)(white + i));
+        __m128i b = _mm_load_si128((const __m128i *)(black + i));
+        __m128i blackToMove = _mm_set_epi64x(-(long long)mover[i + 1], -(long long)mover[i]);
+        __m128i own = _mm_or_si128(_mm_andnot_si128(blackToMove, w), _mm_and_si128(blackToMove, b));
+        __m128i occupied = _mm_or_si128(w, b);
+        __m128i notLeftEdge = _mm_andnot_si128(fileA, own);
+        __m128i notRightEdge = _mm_andnot_si128(fileH, own);
+
+        __m128i toLeft = _mm_andnot_si128(own, _mm_or_si128(_mm_andnot_si128(blackToMove, _mm_srli_epi64(notLeftEdge, 9)),
+                                                            _mm_and_si128(blackToMove, _mm_slli_epi64(notLeftEdge, 7))));
+        __m128i toStraight = _mm_andnot_si128(occupied, _mm_or_si128(_mm_andnot_si128(blackToMove, _mm_srli_epi64(own, 8)),
+                                                                     _mm_and_si128(blackToMove, _mm_slli_epi64(own, 8))));
+        __m128i toRight = _mm_andnot_si128(own, _mm_or_si128(_mm_andnot_si128(blackToMove, _mm_srli_epi64(notRightEdge, 7)),
+                                                             _mm_and_si128(blackToMove, _mm_slli_epi64(notRightEdge, 9))));
+        _mm_store_si128((__m128i *)(left + i), toLeft);
+        _mm_store_si128((__m128i *)(straight + i), toStraight);
+        _mm_store_si128((__m128i *)(right + i), toRight);
+
+        __m128i halves = _mm_cmpeq_epi32(_mm_or_si128(_mm_or_si128(toLeft, toStraight), toRight), zero);
+        __m128i stuckLanes = _mm_and_si128(halves, _mm_shuffle_epi32(halves, _MM_SHUFFLE(2, 3, 0, 1)));
+        int stuck = _mm_movemask_pd(_mm_castsi128_pd(stuckLanes));
+        over[i] = (uint8_t)(over[i] | (stuck & 1));
+        over[i + 1] = (uint8_t)(over[i + 1] | ((stuck >> 1) & 1));
+    }
+    generate_targets_scalar(white + i, black + i, mover + i, left + i, straight + i, right + i, over + i, count - i);
+}
+
+/* Four games per iteration; only called once game_batch_kernel_supported has seen AVX2. */
+__attribute__((target("avx2")))
+static void generate_targets_avx2(const Bitboard *restrict white, const Bitboard *restrict black,
+                                  const uint8_t *restrict mover, Bitboard *restrict left, Bitboard *restrict straight,
+                                  Bitboard *restrict right, uint8_t *restrict over, size_t count) {
+    const __m256i fileA = _mm256_set1_epi64x((long long)FILE_A_MASK);
+    const __m256i fileH = _mm256_set1_epi64x((long long)FILE_H_MASK);
+    const __m256i zero = _mm256_setzero_si256();
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        __m256i w = _mm256_load_si256((const __m256i *)(white + i));
+        __m256i b = _mm256_load_si256((const __m256i *)(black + i));
+        int32_t moverBytes;
+        memcpy(&moverBytes, mover + i, sizeof(moverBytes));
+        __m256i blackToMove = _mm256_sub_epi64(zero, _mm256_cvtepu8_epi64(_mm_cvtsi32_si128(moverBytes)));
+        __m256i own = _mm256_or_si256(_mm256_andnot_si256(blackToMove, w), _mm256_and_si256(blackToMove, b));
+        __m256i occupied = _mm256_or_si256(w, b);
+        __m256i notLeftEdge = _mm256_andnot_si256(fileA, own);
+        __m256i notRightEdge = _mm256_andnot_si256(fileH, own);
+
+        __m256i toLeft = _mm256_andnot_si256(own, _mm256_or_si256(_mm256_andnot_si256(blackToMove, _mm256_srli_epi64(notLeftEdge, 9)),
+                                                                  _mm256_and_si256(blackToMove, _mm256_slli_epi64(notLeftEdge, 7))));
+        __m256i toStraight = _mm256_andnot_si256(occupied, _mm256_or_si256(_mm256_andnot_si256(blackToMove, _mm256_srli_epi64(own, 8)),
+                                                                           _mm256_and_si256(blackToMove, _mm256_slli_epi64(own, 8))));
+        __m256i toRight = _mm256_andnot_si256(own, _mm256_or_si256(_mm256_andnot_si256(blackToMove, _mm256_srli_epi64(notRightEdge, 7)),
+                                                                   _mm256_and_si256(blackToMove, _mm256_slli_epi64(notRightEdge, 9))));
+        _mm256_store_si256((__m256i *)(left + i), toLeft);
+        _mm256_store_si256((__m256i *)(straight + i), toStraight);
+        _mm256_store_si256((__m256i *)(right + i), toRight);
+
+        __m256i stuckLanes = _mm256_cmpeq_epi64(_mm256_or_si256(_mm256_or_si256(toLeft, toStraight), toRight), zero);
+        int stuck = _mm256_movemask_pd(_mm256_castsi256_pd(stuckLanes));
+        for (int lane = 0; lane < 4; ++lane) {
+            over[i + lane] = (uint8_t)(over[i + lane] | ((stuck >> lane) & 1));
+        }
+    }
+    generate_targets_scalar(white + i, black + i, mover + i, left + i, straight + i, right + i, over + i, count - i);
+}
+#endif
+
+void game_batch_generate(GameBatch *batch) {
+    if (!batch) {
+        return;
+    }
+    const Bitboard *white = batch->occupancy[PLAYER_WHITE];
+    const Bitboard *black = batch->occupancy[PLAYER_BLACK];
+    switch (batch->kernel) {
+#ifdef GAME_BATCH_X86
+        case GAME_BATCH_AVX2:
+            generate_targets_avx2(white, black, batch->currentPlayer, batch->targets[0], batch->targets[1],
+                                  batch->targets[2], batch->isGameOver, batch->count);
+            break;
+        case GAME_BATCH_SSE2:
+            generate_targets_sse2(white, black, batch->currentPlayer, batch->targets[0], batch->targets[1],
+                                  batch->targets[2], batch->isGameOver, batch->count);
+            break;
+#endif
+        default:
+            generate_targets_scalar(white, black, batch->currentPlayer, batch->targets[0], batch->targets[1],
+                                    batch->targets[2], batch->isGameOver, batch->count);
+            break;
+    }
+}
+
+size_t game_batch_move_count(const GameBatch *batch, size_t index) {
+    if (!batch || index >= batch->count || batch->isGameOver[index]) {
+        return 0;
+    }
+    return (size_t)(__builtin_popcountll(batch->targets[0][index]) +
+                    __builtin_popcountll(batch->targets[1][index]) +
+                    __builtin_popcountll(batch->targets[2][index]));
+}
+
+/* Square offset of a step for `player` with column delta `delta`. */
+static int step_offset(Player player, int delta) {
+    return ((player == PLAYER_WHITE) ? -BOARD_SIZE : BOARD_SIZE) + delta;
+}
+
+static Position square_position(int index) {
+    return (Position){ index / BOARD_SIZE, index % BOARD_SIZE };
+}
+
+size_t game_batch_list_moves(const GameBatch *batch, size_t index, Move *moves, size_t maxMoves) {
+    if (!batch || !moves || index >= batch->count || batch->isGameOver[index]) {
+        return 0;
+    }
+    Player player = (Player)batch->currentPlayer[index];
+    size_t count = 0;
+    /* PieceType order, like the piece lists game_list_moves follows. */
+    for (int type = 0; type < PIECE_TYPE_COUNT; ++type) {
+        Bitboard own = batch->occupancy[player][index] & batch->pieces[type][index];
+        for (; own && count < maxMoves; own &= own - 1) {
+            int from = __builtin_ctzll(own);
+            for (int delta = -1; delta <= 1 && count < maxMoves; ++delta) {
+                int to = from + step_offset(player, delta);
+                if (to < 0 || to >= BOARD_SIZE * BOARD_SIZE || !(batch->targets[delta + 1][index] & ((Bitboard)1 << to))) {
+                    continue;
+                }
+                moves[count].from = square_position(from);
+                moves[count].to = square_position(to);
+                ++count;
+            }
+        }
+    }
+    return count;
+}
+
+/* Moves a piece the targets already allow; scores a capture and passes the turn. */
+static void play_move(GameBatch *batch, size_t index, int from, int to) {
+    Player player = (Player)batch->currentPlayer[index];
+    Player opponent = game_get_opponent(player);
+    Bitboard fromBit = (Bitboard)1 << from;
+    Bitboard toBit = (Bitboard)1 << to;
+
+    if (batch->occupancy[opponent][index] & toBit) {
+        batch->occupancy[opponent][index] &= ~toBit;
+        batch->score[player][index] += 1;
+    }
+    for (int t = 0; t < PIECE_TYPE_COUNT; ++t) {
+        Bitboard *pieces = &batch->pieces[t][index];
+        Bitboard moved = (*pieces & fromBit) ? toBit : 0;
+        *pieces = (*pieces & ~(fromBit | toBit)) | moved;
+    }
+    batch->occupancy[player][index] ^= fromBit | toBit;
+    batch->currentPlayer[index] = (uint8_t)opponent;
+}
+
+size_t game_batch_apply(GameBatch *batch, const Move *moves) {
+    if (!batch || !moves) {
+        return 0;
+    }
+    size_t moved = 0;
+    for (size_t i = 0; i < batch->count; ++i) {
+        Move move = moves[i];
+        int delta = move.to.col - move.from.col;
+        if (batch->isGameOver[i] || !game_is_valid_position(move.from) || !game_is_valid_position(move.to) ||
+            delta < -1 || delta > 1) {
+            continue;
+        }
+        Player player = (Player)batch->currentPlayer[i];
+        int from = move.from.row * BOARD_SIZE + move.from.col;
+        int to = move.to.row * BOARD_SIZE + move.to.col;
+        if (to != from + step_offset(player, delta) ||
+            !(batch->occupancy[player][i] & ((Bitboard)1 << from)) ||
+            !(batch->targets[delta + 1][i] & ((Bitboard)1 << to))) {
+            continue;
+        }
+        play_move(batch, i, from, to);
+        ++moved;
+    }
+    game_batch_generate(batch);
+    return moved;
+}
+
+/* xorshift64*; one generator steps through the whole batch in game order. */
+static uint64_t next_random(uint64_t *rng) {
+    *rng ^= *rng >> 12;
+    *rng ^= *rng << 25;
+    *rng ^= *rng >> 27;
+    return *rng * 0x2545F4914F6CDD1DULL;
+}
+
+size_t game_batch_play_random(GameBatch *batch, uint64_t *rng) {
+    if (!batch || !rng) {
+        return 0;
+    }
+    size_t moved = 0;
+    for (size_t i = 0; i < batch->count; ++i) {
+        size_t count = game_batch_move_count(batch, i);
+        if (count == 0) {
+            continue;
+        }
+        size_t pick = (size_t)(next_random(rng) % count);
+        for (int d = 0; d < 3; ++d) {
+            Bitboard targets = batch->targets[d][i];
+            size_t available = (size_t)__builtin_popcountll(targets);
+            if (pick >= available) {
+                pick -= available;
+                continue;
+            }
+            for (; pick > 0; --pick) {
+                targets &= targets - 1;
+            }
+            int to = __builtin_ctzll(targets);
+            play_move(batch, i, to - step_offset((Player)batch->currentPlayer[i], d - 1), to);
+            ++moved;
+            break;
+        }
+    }
+    game_batch_generate(batch);
+    return moved;
+}
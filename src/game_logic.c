@@ -22,6 +22,153 @@ static const StartPiece START_PIECES[PLAYER_COUNT][PIECE_TYPE_COUNT] = {
     }
 };
 
+#define FILE_A_MASK 0x0101010101010101ULL
+#define FILE_H_MASK 0x8080808080808080ULL
+
+/* Destination sets for one side, indexed by column delta + 1. */
+typedef struct {
+    Bitboard byDelta[3];
+} MoveTargets;
+
+static inline int square_index(Position pos) {
+    return pos.row * BOARD_SIZE + pos.col;
+}
+
+static inline Bitboard square_bit(Position pos) {
+    return (Bitboard)1 << square_index(pos);
+}
+
+/*
+ * Candidate destinations of a piece on each square, built by the compiler
+ * from constant initializers: the square straight ahead and the one or two
+ * diagonal squares ahead that stay on the board. With these, validation and
+ * generation are a mask against the occupancy with no edge tests.
+ */
+typedef struct {
+    Bitboard straight;
+    Bitboard diagonal;
+} StepTargets;
+
+/* Masking the shift keeps the unselected arm of each conditional well defined. */
+#define STEP_BIT(sq) ((Bitboard)1 << ((sq) & 63))
+#define STEP_ROW(sq) ((sq) / BOARD_SIZE)
+#define STEP_COL(sq) ((sq) % BOARD_SIZE)
+#define STEPS_TOWARD(sq, ahead, hasRowAhead) { \
+    .straight = (hasRowAhead) ? STEP_BIT((sq) + (ahead)) : 0, \
+    .diagonal = (hasRowAhead) ? ((STEP_COL(sq) > 0 ? STEP_BIT((sq) + (ahead) - 1) : 0) | \
+                                 (STEP_COL(sq) < BOARD_SIZE - 1 ? STEP_BIT((sq) + (ahead) + 1) : 0)) : 0 \
+}
+#define WHITE_STEPS(sq) STEPS_TOWARD(sq, -BOARD_SIZE, STEP_ROW(sq) > 0)
+#define BLACK_STEPS(sq) STEPS_TOWARD(sq, BOARD_SIZE, STEP_ROW(sq) < BOARD_SIZE - 1)
+#define STEP_ROW_OF(M, first) M(first), M(first + 1), M(first + 2), M(first + 3), \
+                              M(first + 4), M(first + 5), M(first + 6), M(first + 7)
+#define STEP_BOARD_OF(M) STEP_ROW_OF(M, 0), STEP_ROW_OF(M, 8), STEP_ROW_OF(M, 16), STEP_ROW_OF(M, 24), \
+                         STEP_ROW_OF(M, 32), STEP_ROW_OF(M, 40), STEP_ROW_OF(M, 48), STEP_ROW_OF(M, 56)
+
+static const StepTargets STEP_TARGETS[PLAYER_COUNT][BOARD_SIZE * BOARD_SIZE] = {
+    { STEP_BOARD_OF(WHITE_STEPS) },
+    { STEP_BOARD_OF(BLACK_STEPS) }
+};
+
+/* Squares the piece of `player` on square `from` may move to in this position. */
+static inline Bitboard legal_steps(const GameState *state, Player player, int from) {
+    const StepTargets *steps = &STEP_TARGETS[player][from];
+    Bitboard own = state->occupancy[player];
+    Bitboard empty = ~(state->occupancy[PLAYER_WHITE] | state->occupancy[PLAYER_BLACK]);
+    return (steps->straight & empty) | (steps->diagonal & ~own);
+}
+
+/*
+ * Zobrist keys are derived on demand from a fixed seed with the splitmix64
+ * finalizer, so hashes are stable across runs and there is no shared table
+ * to initialise before worker threads start.
+ */
+#define ZOBRIST_SEED 0x9E3779B97F4A7C15ULL
+#define ZOBRIST_SIDE_INDEX (PLAYER_COUNT * PIECE_TYPE_COUNT * BOARD_SIZE * BOARD_SIZE)
+
+static inline uint64_t zobrist_mix(uint64_t index) {
+    uint64_t z = ZOBRIST_SEED * (index + 1);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+static inline uint64_t zobrist_piece(Player owner, PieceType type, int square) {
+    return zobrist_mix(((uint64_t)owner * PIECE_TYPE_COUNT + (uint64_t)type) * BOARD_SIZE * BOARD_SIZE + (uint64_t)square);
+}
+
+static inline uint64_t zobrist_side(void) {
+    return zobrist_mix(ZOBRIST_SIDE_INDEX);
+}
+
+/*
+ * All pieces step one row forward: WHITE towards row 0 (shift right), BLACK
+ * towards row 7 (shift left). Straight steps need an empty square, diagonal
+ * steps may land on anything but a friendly piece. The file masks stop the
+ * diagonal shifts from wrapping around the board edge. `origins` is the
+ * subset of `own` whose moves are wanted; each origin has at most one
+ * target per column delta.
+ */
+static MoveTargets targets_from(Bitboard origins, Bitboard own, Bitboard empty, Player player) {
+    MoveTargets targets;
+
+    if (player == PLAYER_WHITE) {
+        targets.byDelta[0] = ((origins & ~FILE_A_MASK) >> 9) & ~own;
+        targets.byDelta[1] = (origins >> 8) & empty;
+        targets.byDelta[2] = ((origins & ~FILE_H_MASK) >> 7) & ~own;
+    } else {
+        targets.byDelta[0] = ((origins & ~FILE_A_MASK) << 7) & ~own;
+        targets.byDelta[1] = (origins << 8) & empty;
+        targets.byDelta[2] = ((origins & ~FILE_H_MASK) << 9) & ~own;
+    }
+    return targets;
+}
+
+static MoveTargets compute_move_targets(const GameState *state, Player player) {
+    Bitboard own = state->occupancy[player];
+    Bitboard empty = ~(state->occupancy[PLAYER_WHITE] | state->occupancy[PLAYER_BLACK]);
+    return targets_from(own, own, empty, player);
+}
+
+/* Branch-free popcount; the portable builtin is a library call unless the target has POPCNT. */
+static inline int count_bits(Bitboard bits) {
+    bits -= (bits >> 1) & 0x5555555555555555ULL;
+    bits = (bits & 0x3333333333333333ULL) + ((bits >> 2) & 0x3333333333333333ULL);
+    bits = (bits + (bits >> 4)) & 0x0F0F0F0F0F0F0F0FULL;
+    return (int)((bits * 0x0101010101010101ULL) >> 56);
+}
+
+/*
+ * Number of legal moves `player` has from pieces on the `region` squares.
+ * Two origins can share a target, so the three sets are added bitwise
+ * (carry-save) and the sum and carry words counted.
+ */
+static int count_moves_from(const GameState *state, Player player, Bitboard region) {
+    Bitboard own = state->occupancy[player];
+    Bitboard empty = ~(state->occupancy[PLAYER_WHITE] | state->occupancy[PLAYER_BLACK]);
+    MoveTargets targets = targets_from(own & region, own, empty, player);
+    Bitboard partial = targets.byDelta[0] ^ targets.byDelta[1];
+    Bitboard sum = partial ^ targets.byDelta[2];
+    Bitboard carry = (targets.byDelta[0] & targets.byDelta[1]) | (partial & targets.byDelta[2]);
+    return count_bits(sum) + 2 * count_bits(carry);
+}
+
+/*
+ * A move changes only its two squares, so the only pieces whose moves can
+ * change stand on them or one row behind them, on either side. Shifts that
+ * wrap around an edge just add squares, which leaves the difference exact.
+ */
+static inline Bitboard mobility_region(Bitboard changed) {
+    return changed | (changed << 7) | (changed << 8) | (changed << 9) |
+           (changed >> 7) | (changed >> 8) | (changed >> 9);
+}
+
+static void count_mobility(GameState *state) {
+    for (int player = 0; player < PLAYER_COUNT; ++player) {
+        state->mobility[player] = count_moves_from(state, (Player)player, ~(Bitboard)0);
+    }
+}
+
 static inline bool is_inside(Position pos) {
     return pos.row >= 0 && pos.row < BOARD_SIZE && pos.col >= 0 && pos.col < BOARD_SIZE;
 }
@@ -38,14 +185,75 @@ bool game_is_valid_position(Position pos) {
     return is_inside(pos);
 }
 
+_Static_assert(PIECE_TYPE_COUNT <= 4 && PLAYER_COUNT <= 2, "a piece must fit the 4 bits of a Square");
+
 static void clear_board(GameState *state) {
+    memset(state->board, SQUARE_EMPTY, sizeof(state->board));
+    memset(state->occupancy, 0, sizeof(state->occupancy));
+    memset(state->pieces, 0, sizeof(state->pieces));
+    memset(state->mobility, 0, sizeof(state->mobility));
+    memset(state->pieceSquare, PIECE_SQUARE_NONE, sizeof(state->pieceSquare));
+    state->hash = 0;
+}
+
+/* Adds a piece to its side's piece list, the bitboards and the Zobrist key; false if the entry is taken. */
+static bool index_piece(GameState *state, Position pos, Square sq) {
+    Bitboard bit = square_bit(pos);
+    uint8_t *entry = &state->pieceSquare[square_owner(sq)][square_type(sq)];
+    if (*entry != PIECE_SQUARE_NONE) {
+        return false;
+    }
+    *entry = (uint8_t)square_index(pos);
+    state->occupancy[square_owner(sq)] |= bit;
+    state->pieces[square_type(sq)] |= bit;
+    state->hash ^= zobrist_piece(square_owner(sq), square_type(sq), square_index(pos));
+    return true;
+}
+
+static void unindex_piece(GameState *state, Position pos, Square sq) {
+    Bitboard bit = square_bit(pos);
+    state->pieceSquare[square_owner(sq)][square_type(sq)] = PIECE_SQUARE_NONE;
+    state->occupancy[square_owner(sq)] &= ~bit;
+    state->pieces[square_type(sq)] &= ~bit;
+    state->hash ^= zobrist_piece(square_owner(sq), square_type(sq), square_index(pos));
+}
+
+uint64_t game_compute_hash(const GameState *state) {
+    if (!state) {
+        return 0;
+    }
+
+    uint64_t hash = (state->currentPlayer == PLAYER_BLACK) ? zobrist_side() : 0;
     for (int row = 0; row < BOARD_SIZE; ++row) {
         for (int col = 0; col < BOARD_SIZE; ++col) {
-            state->board[row][col].occupied = false;
-            state->board[row][col].type = PIECE_ROOK;
-            state->board[row][col].owner = PLAYER_WHITE;
+            Square sq = state->board[row][col];
+            if (square_is_occupied(sq)) {
+                hash ^= zobrist_piece(square_owner(sq), square_type(sq), row * BOARD_SIZE + col);
+            }
         }
     }
+    return hash;
+}
+
+bool game_sync_board(GameState *state) {
+    if (!state) {
+        return false;
+    }
+
+    memset(state->occupancy, 0, sizeof(state->occupancy));
+    memset(state->pieces, 0, sizeof(state->pieces));
+    memset(state->pieceSquare, PIECE_SQUARE_NONE, sizeof(state->pieceSquare));
+    state->hash = (state->currentPlayer == PLAYER_BLACK) ? zobrist_side() : 0;
+    for (int row = 0; row < BOARD_SIZE; ++row) {
+        for (int col = 0; col < BOARD_SIZE; ++col) {
+            Square sq = state->board[row][col];
+            if (square_is_occupied(sq) && !index_piece(state, (Position){ row, col }, sq)) {
+                return false;
+            }
+        }
+    }
+    count_mobility(state);
+    return true;
 }
 
 static void place_initial_pieces(GameState *state) {
@@ -55,10 +263,9 @@ static void place_initial_pieces(GameState *state) {
             if (!game_is_valid_position(piece.pos)) {
                 continue;
             }
-            Square *sq = &state->board[piece.pos.row][piece.pos.col];
-            sq->occupied = true;
-            sq->type = piece.type;
-            sq->owner = (Player)player;
+            Square sq = square_make((Player)player, piece.type);
+            state->board[piece.pos.row][piece.pos.col] = sq;
+            index_piece(state, piece.pos, sq);
         }
     }
 }
@@ -82,146 +289,192 @@ void game_reset(GameState *state, GameMode mode) {
     state->isGameOver = false;
 
     place_initial_pieces(state);
+    count_mobility(state);
 }
 
-static bool square_contains_player_piece(const GameState *state, Position pos, Player player) {
-    if (!is_inside(pos)) {
+bool game_is_valid_move(const GameState *state, Position from, Position to) {
+    if (!state || !is_inside(from) || !is_inside(to)) {
         return false;
     }
-    const Square *sq = &state->board[pos.row][pos.col];
-    return sq->occupied && sq->owner == player;
-}
 
-static bool is_valid_destination(const Square *fromSquare, const Square *toSquare, int colDiff) {
-    if (!toSquare->occupied) {
-        return true;
-    }
-    if (toSquare->owner == fromSquare->owner) {
+    Square fromSquare = state->board[from.row][from.col];
+    if (!square_is_occupied(fromSquare)) {
         return false;
     }
-    return (colDiff != 0);
+    return (legal_steps(state, square_owner(fromSquare), square_index(from)) & square_bit(to)) != 0;
 }
 
-bool game_is_valid_move(const GameState *state, Position from, Position to) {
-    if (!state || !is_inside(from) || !is_inside(to)) {
-        return false;
+/*
+ * Moves the piece at `from`; the caller has already validated the move.
+ * Mobility is recounted only around the two squares that change.
+ */
+static void apply_move_internal(GameState *state, Position from, Position to) {
+    Square *fromSquare = &state->board[from.row][from.col];
+    Square *toSquare = &state->board[to.row][to.col];
+    Bitboard region = mobility_region(square_bit(from) | square_bit(to));
+    int before[PLAYER_COUNT];
+    for (int player = 0; player < PLAYER_COUNT; ++player) {
+        before[player] = count_moves_from(state, (Player)player, region);
     }
-    if (from.row == to.row && from.col == to.col) {
-        return false;
+
+    Player mover = square_owner(*fromSquare);
+
+    if (square_is_occupied(*toSquare)) {
+        if (square_owner(*toSquare) != mover) {
+            state->score[mover] += 1;
+        }
+        unindex_piece(state, to, *toSquare);
     }
 
-    const Square *fromSquare = &state->board[from.row][from.col];
-    if (!fromSquare->occupied) {
+    unindex_piece(state, from, *fromSquare);
+    *toSquare = *fromSquare;
+    *fromSquare = SQUARE_EMPTY;
+    index_piece(state, to, *toSquare);
+
+    for (int player = 0; player < PLAYER_COUNT; ++player) {
+        state->mobility[player] += count_moves_from(state, (Player)player, region) - before[player];
+    }
+}
+
+bool game_make_move(GameState *state, Move move, MoveUndo *undo) {
+    if (!state || !undo || state->isGameOver) {
         return false;
     }
 
-    int dir = forward_direction(fromSquare->owner);
-    if (to.row != from.row + dir) {
+    Position from = move.from;
+    Position to = move.to;
+    if (!is_inside(from) || !is_inside(to)) {
         return false;
     }
 
-    int colDiff = to.col - from.col;
-    if (colDiff < -1 || colDiff > 1) {
+    Square fromSquare = state->board[from.row][from.col];
+    if (!square_is_occupied(fromSquare) || square_owner(fromSquare) != state->currentPlayer) {
         return false;
     }
 
-    const Square *toSquare = &state->board[to.row][to.col];
-    if (colDiff == 0) {
-        return !toSquare->occupied;
+    if (!game_is_valid_move(state, from, to)) {
+        return false;
     }
 
-    return is_valid_destination(fromSquare, toSquare, colDiff);
+    undo->move = move;
+    undo->captured = state->board[to.row][to.col];
+    undo->previousScore = state->score[state->currentPlayer];
+    undo->previousGameOver = state->isGameOver;
+    memcpy(undo->previousMobility, state->mobility, sizeof(undo->previousMobility));
+
+    apply_move_internal(state, from, to);
+
+    state->currentPlayer = game_get_opponent(state->currentPlayer);
+    state->hash ^= zobrist_side();
+    state->isGameOver = state->mobility[state->currentPlayer] == 0;
+
+    return true;
 }
 
-static bool apply_move_internal(GameState *state, Position from, Position to, bool dryRun) {
-    if (!game_is_valid_move(state, from, to)) {
-        return false;
+void game_unmake_move(GameState *state, const MoveUndo *undo) {
+    if (!state || !undo) {
+        return;
     }
 
+    Position from = undo->move.from;
+    Position to = undo->move.to;
     Square *fromSquare = &state->board[from.row][from.col];
     Square *toSquare = &state->board[to.row][to.col];
 
-    Player mover = fromSquare->owner;
+    Player mover = square_owner(*toSquare);
 
-    if (!dryRun && toSquare->occupied && toSquare->owner != mover) {
-        state->score[mover] += 1;
-    }
+    unindex_piece(state, to, *toSquare);
+    *fromSquare = *toSquare;
+    index_piece(state, from, *fromSquare);
 
-    if (!dryRun) {
-        *toSquare = *fromSquare;
-        fromSquare->occupied = false;
+    *toSquare = undo->captured;
+    if (square_is_occupied(*toSquare)) {
+        index_piece(state, to, *toSquare);
     }
 
-    return true;
+    state->score[mover] = undo->previousScore;
+    state->currentPlayer = mover;
+    state->hash ^= zobrist_side();
+    state->isGameOver = undo->previousGameOver;
+    memcpy(state->mobility, undo->previousMobility, sizeof(state->mobility));
 }
 
 bool game_apply_move(GameState *state, Position from, Position to) {
-    if (!state || state->isGameOver || state->isPaused) {
-        return false;
-    }
-
-    if (!is_inside(from) || !is_inside(to)) {
+    if (!state || state->isPaused) {
         return false;
     }
 
-    Square *fromSquare = &state->board[from.row][from.col];
-    if (!fromSquare->occupied || fromSquare->owner != state->currentPlayer) {
-        return false;
-    }
+    MoveUndo undo;
+    return game_make_move(state, (Move){ from, to }, &undo);
+}
 
-    if (!apply_move_internal(state, from, to, false)) {
-        return false;
+size_t game_list_moves(const GameState *state, Player player, Move *moves, size_t maxMoves) {
+    if (!state) {
+        return 0;
     }
 
-    state->currentPlayer = game_get_opponent(state->currentPlayer);
+    size_t count = 0;
 
-    if (!game_has_any_moves(state, state->currentPlayer)) {
-        state->isGameOver = true;
+    /*
+     * Pieces are visited in PieceType order, the order of the piece list;
+     * destinations in increasing square order, i.e. column delta -1, 0, +1.
+     */
+    for (int type = 0; type < PIECE_TYPE_COUNT; ++type) {
+        int index = state->pieceSquare[player][type];
+        if (index == PIECE_SQUARE_NONE) {
+            continue;
+        }
+        Position from = { index / BOARD_SIZE, index % BOARD_SIZE };
+
+        for (Bitboard steps = legal_steps(state, player, index); steps; steps &= steps - 1) {
+            int target = __builtin_ctzll(steps);
+            Position to = { target / BOARD_SIZE, target % BOARD_SIZE };
+            if (moves && count < maxMoves) {
+                moves[count].from = from;
+                moves[count].to = to;
+            }
+            ++count;
+            if (!moves && count > 0) {
+                return count;
+            }
+            if (moves && count >= maxMoves) {
+                return count;
+            }
+        }
     }
-
-    return true;
+    return count;
 }
 
-size_t game_list_moves(const GameState *state, Player player, Move *moves, size_t maxMoves) {
-    if (!state) {
+/*
+ * Walks the capturing targets directly instead of every own piece; each
+ * target square maps back to exactly one origin square per diagonal.
+ */
+size_t game_list_captures(const GameState *state, Player player, Move *moves, size_t maxMoves) {
+    if (!state || !moves) {
         return 0;
     }
 
+    MoveTargets targets = compute_move_targets(state, player);
+    Bitboard enemy = state->occupancy[game_get_opponent(player)];
+    int dir = forward_direction(player);
     size_t count = 0;
-    for (int row = 0; row < BOARD_SIZE; ++row) {
-        for (int col = 0; col < BOARD_SIZE; ++col) {
-            Position from = { row, col };
-            if (!square_contains_player_piece(state, from, player)) {
-                continue;
-            }
 
-            int dir = forward_direction(player);
-            for (int deltaCol = -1; deltaCol <= 1; ++deltaCol) {
-                Position to = { row + dir, col + deltaCol };
-                if (!is_inside(to)) {
-                    continue;
-                }
-                GameState temp = *state;
-                if (apply_move_internal(&temp, from, to, true)) {
-                    if (moves && count < maxMoves) {
-                        moves[count].from = from;
-                        moves[count].to = to;
-                    }
-                    ++count;
-                    if (!moves && count > 0) {
-                        return count;
-                    }
-                    if (moves && count >= maxMoves) {
-                        return count;
-                    }
-                }
-            }
+    for (int deltaCol = -1; deltaCol <= 1; deltaCol += 2) {
+        Bitboard hits = targets.byDelta[deltaCol + 1] & enemy;
+        for (; hits && count < maxMoves; hits &= hits - 1) {
+            int index = __builtin_ctzll(hits);
+            Position to = { index / BOARD_SIZE, index % BOARD_SIZE };
+            moves[count].from = (Position){ to.row - dir, to.col - deltaCol };
+            moves[count].to = to;
+            ++count;
         }
     }
     return count;
 }
 
 bool game_has_any_moves(const GameState *state, Player player) {
-    Move moves[1];
-    return game_list_moves(state, player, moves, 1) > 0;
+    if (!state) {
+        return false;
+    }
+    return state->mobility[player] > 0;
 }
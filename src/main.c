@@ -5,9 +5,12 @@
 #include "game_logic.h"
 #include "ui.h"
 #include "ai.h"
+#include "ai_worker.h"
 #include "chat.h"
 #include "file_io.h"
 
+#define PVE_DIFFICULTY AI_DIFFICULTY_MEDIUM
+
 static void start_new_game(GameState *game, ChatLog *chat, UiState *ui, GameMode mode, const char *statusMessage) {
     game_reset(game, mode);
     chat_init(chat);
@@ -26,7 +29,13 @@ static void start_new_game(GameState *game, ChatLog *chat, UiState *ui, GameMode
     }
 }
 
-static void process_command(const UiCommand *command, UiState *ui, GameState *game, ChatLog *chat) {
+static void request_ai_reply(const GameState *game, AiWorker *ai) {
+    AiSearchLimits limits;
+    ai_limits_for_difficulty(PVE_DIFFICULTY, &limits);
+    ai_worker_request(ai, game, &limits);
+}
+
+static void process_command(const UiCommand *command, UiState *ui, GameState *game, ChatLog *chat, AiWorker *ai) {
     if (!command || !ui || !game || !chat) {
         return;
     }
@@ -38,18 +47,22 @@ static void process_command(const UiCommand *command, UiState *ui, GameState *ga
             ui->running = false;
             break;
         case UI_CMD_START_PVE:
+            ai_worker_cancel(ai);
             start_new_game(game, chat, ui, MODE_PVE, "New game vs Computer started.");
             break;
         case UI_CMD_START_PVP:
+            ai_worker_cancel(ai);
             start_new_game(game, chat, ui, MODE_PVP, "New two-player game started.");
             break;
         case UI_CMD_MAIN_MENU:
+            ai_worker_cancel(ai);
             ui_set_view(ui, UI_VIEW_MAIN_MENU);
             ui_reset_game_interaction(ui);
             game_reset(game, MODE_NONE);
             ui_set_status_message(ui, "Returned to main menu.");
             break;
         case UI_CMD_PAUSE:
+            ai_worker_cancel(ai);
             game->isPaused = true;
             ui_set_view(ui, UI_VIEW_PAUSE);
             ui_set_status_message(ui, "Game paused.");
@@ -67,6 +80,7 @@ static void process_command(const UiCommand *command, UiState *ui, GameState *ga
             }
             break;
         case UI_CMD_LOAD:
+            ai_worker_cancel(ai);
             if (load_game_from_path(game, chat, SAVE_FILE_PATH)) {
                 ui_reset_game_interaction(ui);
                 ui_set_view(ui, UI_VIEW_GAME);
@@ -76,6 +90,10 @@ static void process_command(const UiCommand *command, UiState *ui, GameState *ga
             }
             break;
         case UI_CMD_PLAYER_MOVE: {
+            if (game->mode == MODE_PVE && game->currentPlayer == PLAYER_BLACK) {
+                ui_set_status_message(ui, "Computer is thinking.");
+                break;
+            }
             if (game_apply_move(game, command->move.from, command->move.to)) {
                 ui_reset_game_interaction(ui);
                 if (game->isGameOver) {
@@ -86,6 +104,10 @@ static void process_command(const UiCommand *command, UiState *ui, GameState *ga
                     chat_add(chat, CHAT_SPEAKER_SYSTEM, msg);
                 } else {
                     ui_set_status_message(ui, "Move applied.");
+                    if (game->mode == MODE_PVE) {
+                        /* Ask now so a pondered reply lands on the next frame. */
+                        request_ai_reply(game, ai);
+                    }
                 }
             } else {
                 ui_set_status_message(ui, "Invalid move.");
@@ -101,29 +123,19 @@ static void process_command(const UiCommand *command, UiState *ui, GameState *ga
     }
 }
 
-static void maybe_run_ai(GameState *game, ChatLog *chat, UiState *ui) {
-    if (!game || !chat || !ui) {
-        return;
-    }
-    if (game->mode != MODE_PVE) {
-        return;
-    }
-    if (game->isPaused || game->isGameOver) {
-        return;
-    }
-    if (game->currentPlayer != PLAYER_BLACK) {
+static void apply_ai_result(GameState *game, ChatLog *chat, UiState *ui, const AiWorkerResult *result) {
+    if (game->mode != MODE_PVE || game->isPaused || game->isGameOver || game->currentPlayer != PLAYER_BLACK) {
         return;
     }
 
-    Move aiMove;
-    if (!ai_pick_move(game, &aiMove)) {
+    if (!result->hasMove) {
         game->isGameOver = true;
         ui_set_status_message(ui, "Computer cannot move. You win!");
         chat_add(chat, CHAT_SPEAKER_SYSTEM, "Computer cannot move. You win!");
         return;
     }
 
-    if (game_apply_move(game, aiMove.from, aiMove.to)) {
+    if (game_apply_move(game, result->move.from, result->move.to)) {
         chat_add(chat, CHAT_SPEAKER_SYSTEM, "Computer played a move.");
         if (game->isGameOver) {
             const char *winner = (game->score[PLAYER_WHITE] == game->score[PLAYER_BLACK]) ? "No one" : (game->score[PLAYER_WHITE] > game->score[PLAYER_BLACK] ? "WHITE" : "BLACK");
@@ -135,17 +147,58 @@ static void maybe_run_ai(GameState *game, ChatLog *chat, UiState *ui) {
     }
 }
 
+static void drain_ai_results(GameState *game, ChatLog *chat, UiState *ui, AiWorker *ai) {
+    AiWorkerResult result;
+    while (ai_worker_poll(ai, &result)) {
+        apply_ai_result(game, chat, ui, &result);
+    }
+}
+
+/*
+ * Hands the computer's turn to the background worker; the frame loop never
+ * waits on it. On the human's turn the worker ponders their likely replies.
+ */
+static void maybe_run_ai(GameState *game, ChatLog *chat, UiState *ui, AiWorker *ai) {
+    if (!game || !chat || !ui) {
+        return;
+    }
+    if (game->mode != MODE_PVE) {
+        return;
+    }
+    if (game->isPaused || game->isGameOver) {
+        return;
+    }
+    if (game->currentPlayer != PLAYER_BLACK) {
+        AiSearchLimits limits;
+        ai_limits_for_difficulty(PVE_DIFFICULTY, &limits);
+        ai_worker_ponder(ai, game, &limits);
+        return;
+    }
+
+    if (!ai_worker_pending(ai)) {
+        request_ai_reply(game, ai);
+    }
+}
+
 int main(void) {
     GameState game;
     ChatLog chat;
     UiState ui;
+    AiWorker ai;
 
-    ai_init();
+    ai_init(NULL);
+    if (!ai_worker_start(&ai)) {
+        fprintf(stderr, "Failed to start AI worker thread\n");
+        ai_shutdown();
+        return 1;
+    }
     chat_init(&chat);
     game_init(&game, MODE_NONE);
 
     if (!ui_init(&ui, "Simplified Chess")) {
         fprintf(stderr, "Failed to initialize UI: %s\n", SDL_GetError());
+        ai_worker_stop(&ai);
+        ai_shutdown();
         return 1;
     }
 
@@ -156,11 +209,12 @@ int main(void) {
         while (SDL_PollEvent(&event)) {
             UiCommand command;
             if (ui_handle_event(&ui, &event, &game, &command) && command.type != UI_CMD_NONE) {
-                process_command(&command, &ui, &game, &chat);
+                process_command(&command, &ui, &game, &chat, &ai);
             }
         }
 
-        maybe_run_ai(&game, &chat, &ui);
+        drain_ai_results(&game, &chat, &ui, &ai);
+        maybe_run_ai(&game, &chat, &ui, &ai);
 
         Uint32 currentTicks = SDL_GetTicks();
         Uint32 delta = currentTicks - lastTicks;
@@ -172,5 +226,7 @@ int main(void) {
     }
 
     ui_cleanup(&ui);
+    ai_worker_stop(&ai);
+    ai_shutdown();
     return 0;
 }
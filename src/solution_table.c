@@ -0,0 +1,134 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include "solution_table.h"
+
+#include <fcntl.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+static uint64_t key_hash(const SolutionKey *key) {
+    uint64_t h = key->occupied * 0x9E3779B97F4A7C15ULL;
+    h ^= ((uint64_t)key->whiteMask << 1 | key->sideToMove) * 0xC2B2AE3D27D4EB4FULL;
+    h ^= h >> 31;
+    h *= 0xBF58476D1CE4E5B9ULL;
+    return h ^ (h >> 29);
+}
+
+static bool slot_matches(const SolutionSlot *slot, const SolutionKey *key) {
+    return slot->occupied == key->occupied && slot->whiteMask == key->whiteMask && slot->sideToMove == key->sideToMove;
+}
+
+/* Index of the slot holding the key, or of the empty slot ending its probe chain. */
+static uint64_t find_index(const SolutionSlot *slots, uint64_t slotMask, const SolutionKey *key) {
+    uint64_t index = key_hash(key) & slotMask;
+    for (uint64_t probes = 0; probes <= slotMask; ++probes) {
+        const SolutionSlot *slot = &slots[index];
+        if (slot->occupied == 0 || slot_matches(slot, key)) {
+            return index;
+        }
+        index = (index + 1) & slotMask;
+    }
+    return index;
+}
+
+bool solution_key_from_state(const GameState *state, SolutionKey *outKey) {
+    if (!state || !outKey) {
+        return false;
+    }
+
+    Bitboard white = state->occupancy[PLAYER_WHITE];
+    Bitboard occupied = white | state->occupancy[PLAYER_BLACK];
+    uint16_t whiteMask = 0;
+    int piece = 0;
+    for (Bitboard rest = occupied; rest; rest &= rest - 1, ++piece) {
+        if (piece >= SOLUTION_MAX_PIECES) {
+            return false;
+        }
+        if (white & rest & (~rest + 1)) {
+            whiteMask |= (uint16_t)(1u << piece);
+        }
+    }
+
+    outKey->occupied = occupied;
+    outKey->whiteMask = whiteMask;
+    outKey->sideToMove = (uint8_t)state->currentPlayer;
+    return true;
+}
+
+SolutionSlot *solution_slot_find(SolutionSlot *slots, uint64_t slotMask, const SolutionKey *key) {
+    if (!slots || !key) {
+        return NULL;
+    }
+    return &slots[find_index(slots, slotMask, key)];
+}
+
+bool solution_table_open(SolutionTable *table, const char *path) {
+    if (!table || !path) {
+        return false;
+    }
+    memset(table, 0, sizeof(*table));
+
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        return false;
+    }
+
+    struct stat info;
+    if (fstat(fd, &info) != 0 || (size_t)info.st_size < sizeof(SolutionTableHeader)) {
+        close(fd);
+        return false;
+    }
+
+    size_t size = (size_t)info.st_size;
+    void *mapping = mmap(NULL, size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (mapping == MAP_FAILED) {
+        return false;
+    }
+
+    const SolutionTableHeader *header = mapping;
+    uint64_t slotCount = header->slotCount;
+    bool valid = memcmp(header->magic, SOLUTION_TABLE_MAGIC, sizeof(header->magic)) == 0 &&
+                 header->version == SOLUTION_TABLE_VERSION &&
+                 header->slotSize == sizeof(SolutionSlot) &&
+                 slotCount > 0 && (slotCount & (slotCount - 1)) == 0 &&
+                 slotCount <= (size - sizeof(SolutionTableHeader)) / sizeof(SolutionSlot);
+    if (!valid) {
+        munmap(mapping, size);
+        return false;
+    }
+
+    table->mapping = mapping;
+    table->mappingSize = size;
+    table->slots = (const SolutionSlot *)((const char *)mapping + sizeof(SolutionTableHeader));
+    table->slotMask = slotCount - 1;
+    table->entryCount = header->entryCount;
+    return true;
+}
+
+void solution_table_close(SolutionTable *table) {
+    if (!table || !table->mapping) {
+        return;
+    }
+    munmap(table->mapping, table->mappingSize);
+    memset(table, 0, sizeof(*table));
+}
+
+bool solution_table_probe(const SolutionTable *table, const GameState *state, int *outValue) {
+    if (!table || !table->slots || !state || !outValue) {
+        return false;
+    }
+
+    SolutionKey key;
+    if (!solution_key_from_state(state, &key)) {
+        return false;
+    }
+    const SolutionSlot *slot = &table->slots[find_index(table->slots, table->slotMask, &key)];
+    if (!slot_matches(slot, &key)) {
+        return false;
+    }
+    *outValue = slot->value;
+    return true;
+}
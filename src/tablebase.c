@@ -0,0 +1,144 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include "tablebase.h"
+
+#include <fcntl.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#define SQUARE_COUNT (BOARD_SIZE * BOARD_SIZE)
+
+static uint64_t choose(int n, int k) {
+    if (k < 0 || n < k) {
+        return 0;
+    }
+    uint64_t result = 1;
+    for (int i = 1; i <= k; ++i) {
+        result = result * (uint64_t)(n - k + i) / (uint64_t)i;
+    }
+    return result;
+}
+
+/* Colex rank of the set bits of `squares` among all sets of that size. */
+static uint64_t combination_rank(Bitboard squares) {
+    uint64_t rank = 0;
+    int i = 1;
+    for (; squares; squares &= squares - 1, ++i) {
+        rank += choose(__builtin_ctzll(squares), i);
+    }
+    return rank;
+}
+
+static uint64_t class_size(int whiteCount, int blackCount) {
+    return choose(SQUARE_COUNT, whiteCount) * choose(SQUARE_COUNT, blackCount) * PLAYER_COUNT;
+}
+
+/* Classes are laid out by total pieces, then by white count. */
+static uint64_t class_offset(int whiteCount, int blackCount) {
+    uint64_t offset = 0;
+    for (int total = 2; total <= TABLEBASE_MAX_PIECES; ++total) {
+        for (int white = 1; white < total; ++white) {
+            if (white == whiteCount && total - white == blackCount) {
+                return offset;
+            }
+            offset += class_size(white, total - white);
+        }
+    }
+    return offset;
+}
+
+uint64_t tablebase_entry_count(void) {
+    /* No class has zero black pieces, so this sums every class. */
+    return class_offset(TABLEBASE_MAX_PIECES + 1, 0);
+}
+
+bool tablebase_entry_index(Bitboard white, Bitboard black, Player sideToMove, uint64_t *outIndex) {
+    int whiteCount = __builtin_popcountll(white);
+    int blackCount = __builtin_popcountll(black);
+    if (whiteCount == 0 || blackCount == 0 || whiteCount + blackCount > TABLEBASE_MAX_PIECES || (white & black)) {
+        return false;
+    }
+
+    uint64_t index = combination_rank(white) * choose(SQUARE_COUNT, blackCount) + combination_rank(black);
+    *outIndex = class_offset(whiteCount, blackCount) + index * PLAYER_COUNT + (uint64_t)sideToMove;
+    return true;
+}
+
+bool tablebase_open(Tablebase *tb, const char *path) {
+    if (!tb || !path) {
+        return false;
+    }
+    memset(tb, 0, sizeof(*tb));
+
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        return false;
+    }
+
+    struct stat info;
+    if (fstat(fd, &info) != 0 || (size_t)info.st_size < sizeof(TablebaseHeader)) {
+        close(fd);
+        return false;
+    }
+
+    size_t size = (size_t)info.st_size;
+    void *mapping = mmap(NULL, size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (mapping == MAP_FAILED) {
+        return false;
+    }
+
+    const TablebaseHeader *header = mapping;
+    uint64_t entryCount = tablebase_entry_count();
+    bool valid = memcmp(header->magic, TABLEBASE_MAGIC, sizeof(header->magic)) == 0 &&
+                 header->version == TABLEBASE_VERSION &&
+                 header->maxPieces == TABLEBASE_MAX_PIECES &&
+                 header->entryCount == entryCount &&
+                 (entryCount + 1) / 2 <= size - sizeof(TablebaseHeader);
+    if (!valid) {
+        munmap(mapping, size);
+        return false;
+    }
+
+    tb->mapping = mapping;
+    tb->mappingSize = size;
+    tb->data = (const uint8_t *)mapping + sizeof(TablebaseHeader);
+    tb->entryCount = entryCount;
+    return true;
+}
+
+void tablebase_close(Tablebase *tb) {
+    if (!tb || !tb->mapping) {
+        return;
+    }
+    munmap(tb->mapping, tb->mappingSize);
+    memset(tb, 0, sizeof(*tb));
+}
+
+bool tablebase_probe(const Tablebase *tb, const GameState *state, int *outValue) {
+    if (!tb || !tb->data || !state || !outValue) {
+        return false;
+    }
+
+    Bitboard white = state->occupancy[PLAYER_WHITE];
+    Bitboard black = state->occupancy[PLAYER_BLACK];
+    if ((white == 0 || black == 0) && __builtin_popcountll(white | black) <= TABLEBASE_MAX_PIECES) {
+        *outValue = 0;
+        return true;
+    }
+
+    uint64_t index;
+    if (!tablebase_entry_index(white, black, state->currentPlayer, &index)) {
+        return false;
+    }
+
+    uint8_t byte = tb->data[index / 2];
+    int nibble = (index & 1) ? (byte >> 4) : (byte & 0x0F);
+    if (nibble == 0) {
+        return false;
+    }
+    *outValue = nibble - TABLEBASE_VALUE_BIAS;
+    return true;
+}
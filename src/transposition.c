@@ -0,0 +1,164 @@
+#include "transposition.h"
+
+#include <stdlib.h>
+
+/*
+ * Each bucket holds a depth-preferred slot and an always-replace slot. The
+ * packed entry layout is:
+ *   bits  0-23  score + TT_SCORE_BIAS
+ *   bits 24-31  depth
+ *   bits 32-33  bound
+ *   bits 34-39  best move origin square
+ *   bits 40-45  best move destination square
+ *   bit  46     best move present
+ *   bits 48-55  search generation
+ */
+#define TT_BUCKET_SLOTS 2
+#define TT_SCORE_BIAS (1 << 23)
+
+static uint64_t pack_entry(int depth, TtBound bound, int score, const Move *bestMove, unsigned int generation) {
+    uint64_t data = (uint64_t)(uint32_t)(score + TT_SCORE_BIAS) & 0xFFFFFFULL;
+    data |= (uint64_t)(depth & 0xFF) << 24;
+    data |= (uint64_t)bound << 32;
+    if (bestMove) {
+        data |= (uint64_t)(bestMove->from.row * BOARD_SIZE + bestMove->from.col) << 34;
+        data |= (uint64_t)(bestMove->to.row * BOARD_SIZE + bestMove->to.col) << 40;
+        data |= 1ULL << 46;
+    }
+    data |= (uint64_t)(generation & 0xFF) << 48;
+    return data;
+}
+
+static void unpack_entry(uint64_t data, TtEntry *out) {
+    out->score = (int)(data & 0xFFFFFFULL) - TT_SCORE_BIAS;
+    out->depth = (int)((data >> 24) & 0xFF);
+    out->bound = (TtBound)((data >> 32) & 0x3);
+    out->hasMove = ((data >> 46) & 1ULL) != 0;
+    int from = (int)((data >> 34) & 0x3F);
+    int to = (int)((data >> 40) & 0x3F);
+    out->bestMove.from = (Position){ from / BOARD_SIZE, from % BOARD_SIZE };
+    out->bestMove.to = (Position){ to / BOARD_SIZE, to % BOARD_SIZE };
+}
+
+static inline int entry_depth(uint64_t data) {
+    return (int)((data >> 24) & 0xFF);
+}
+
+static inline TtBound entry_bound(uint64_t data) {
+    return (TtBound)((data >> 32) & 0x3);
+}
+
+static inline unsigned int entry_generation(uint64_t data) {
+    return (unsigned int)((data >> 48) & 0xFF);
+}
+
+static inline TtSlot *bucket_for(const TranspositionTable *table, uint64_t key) {
+    return &table->slots[(size_t)(key & table->bucketMask) * TT_BUCKET_SLOTS];
+}
+
+bool tt_init(TranspositionTable *table, size_t megabytes) {
+    if (!table) {
+        return false;
+    }
+
+    size_t bytes = (megabytes ? megabytes : 1) * 1024 * 1024;
+    size_t bucketBytes = sizeof(TtSlot) * TT_BUCKET_SLOTS;
+    size_t buckets = 1;
+    while (buckets * 2 * bucketBytes <= bytes) {
+        buckets *= 2;
+    }
+
+    table->slots = calloc(buckets * TT_BUCKET_SLOTS, sizeof(TtSlot));
+    if (!table->slots) {
+        table->bucketMask = 0;
+        return false;
+    }
+    table->bucketMask = buckets - 1;
+    atomic_init(&table->generation, 0);
+    tt_clear(table);
+    return true;
+}
+
+void tt_free(TranspositionTable *table) {
+    if (!table) {
+        return;
+    }
+    free(table->slots);
+    table->slots = NULL;
+    table->bucketMask = 0;
+}
+
+void tt_clear(TranspositionTable *table) {
+    if (!table || !table->slots) {
+        return;
+    }
+    size_t slotCount = (table->bucketMask + 1) * TT_BUCKET_SLOTS;
+    for (size_t i = 0; i < slotCount; ++i) {
+        atomic_store_explicit(&table->slots[i].check, 0, memory_order_relaxed);
+        atomic_store_explicit(&table->slots[i].data, 0, memory_order_relaxed);
+    }
+}
+
+void tt_new_search(TranspositionTable *table) {
+    if (table) {
+        atomic_fetch_add_explicit(&table->generation, 1, memory_order_relaxed);
+    }
+}
+
+bool tt_probe(const TranspositionTable *table, uint64_t key, TtEntry *outEntry) {
+    if (!table || !table->slots || !outEntry) {
+        return false;
+    }
+
+    TtSlot *bucket = bucket_for(table, key);
+    for (int i = 0; i < TT_BUCKET_SLOTS; ++i) {
+        uint64_t data = atomic_load_explicit(&bucket[i].data, memory_order_relaxed);
+        uint64_t check = atomic_load_explicit(&bucket[i].check, memory_order_relaxed);
+        if ((check ^ data) != key) {
+            continue;
+        }
+        unpack_entry(data, outEntry);
+        if (outEntry->bound != TT_BOUND_NONE) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void tt_store(TranspositionTable *table, uint64_t key, int depth, TtBound bound, int score, const Move *bestMove) {
+    if (!table || !table->slots) {
+        return;
+    }
+
+    unsigned int generation = atomic_load_explicit(&table->generation, memory_order_relaxed) & 0xFF;
+    if (depth > TT_MAX_DEPTH) {
+        depth = TT_MAX_DEPTH;
+    }
+
+    TtSlot *bucket = bucket_for(table, key);
+    uint64_t oldData = atomic_load_explicit(&bucket[0].data, memory_order_relaxed);
+    uint64_t oldCheck = atomic_load_explicit(&bucket[0].check, memory_order_relaxed);
+    bool samePosition = (oldCheck ^ oldData) == key;
+
+    /*
+     * A deeper result for this position, solved ones included, is kept over
+     * a shallower one, and an exact score over a bound of the same depth.
+     * Otherwise the depth-preferred slot takes the new entry if it is at
+     * least as deep or left over from an earlier search.
+     */
+    TtSlot *slot = &bucket[1];
+    if (samePosition) {
+        int oldDepth = entry_depth(oldData);
+        if (oldDepth > depth ||
+            (oldDepth == depth && entry_bound(oldData) == TT_BOUND_EXACT && bound != TT_BOUND_EXACT)) {
+            return;
+        }
+        slot = &bucket[0];
+    } else if (entry_depth(oldData) <= depth || entry_generation(oldData) != generation) {
+        slot = &bucket[0];
+    }
+
+    uint64_t data = pack_entry(depth, bound, score, bestMove, generation);
+    atomic_store_explicit(&slot->data, data, memory_order_relaxed);
+    atomic_store_explicit(&slot->check, key ^ data, memory_order_relaxed);
+}
@@ -398,9 +398,9 @@ static void render_board(UiState *ui, const GameState *game) {
             SDL_Color outline = { 30, 30, 30, 255 };
             draw_rect_outline(renderer, tile, outline);
 
-            const Square *sq = &game->board[row][col];
-            if (sq->occupied) {
-                draw_piece(ui, tile, sq->type, sq->owner);
+            Square sq = game->board[row][col];
+            if (square_is_occupied(sq)) {
+                draw_piece(ui, tile, square_type(sq), square_owner(sq));
             }
         }
     }
@@ -746,8 +746,8 @@ static bool handle_game_click(UiState *ui, const GameState *game, int x, int y,
     Position boardPos;
     if (screen_to_board(ui, x, y, &boardPos)) {
         if (!ui->hasSelection) {
-            const Square *sq = &game->board[boardPos.row][boardPos.col];
-            if (sq->occupied && sq->owner == game->currentPlayer) {
+            Square sq = game->board[boardPos.row][boardPos.col];
+            if (square_is_occupied(sq) && square_owner(sq) == game->currentPlayer) {
                 ui->hasSelection = true;
                 ui->selectedSquare = boardPos;
             }
@@ -0,0 +1,136 @@
+#define _POSIX_C_SOURCE 200809L
+#include "game_logic.h"
+#include "file_io.h"
+
+#include <stdio.h>
+#include <string.h>
+
+/* Plays `plies` moves from the start position, taking the `pick`-th listed move each time. */
+static void play_opening(GameState *state, int plies, size_t pick) {
+    game_init(state, MODE_PVE);
+    for (int i = 0; i < plies; ++i) {
+        Move moves[MAX_MOVES_PER_TURN];
+        size_t count = game_list_moves(state, state->currentPlayer, moves, MAX_MOVES_PER_TURN);
+        if (count == 0) {
+            return;
+        }
+        MoveUndo undo;
+        game_make_move(state, moves[pick % count], &undo);
+    }
+}
+
+/* The text save_game_to_path writes for `state`. */
+static size_t format_save(const GameState *state, char *buf, size_t size) {
+    static const char pieceChars[PIECE_TYPE_COUNT] = { 'R', 'N', 'B', 'Q' };
+    size_t len = (size_t)snprintf(buf, size, "CHESS_SAVE_V1\n%d %d %d %d %d %d\n", (int)state->mode,
+                                  (int)state->currentPlayer, state->score[0], state->score[1],
+                                  (int)state->isPaused, (int)state->isGameOver);
+    for (int r = 0; r < BOARD_SIZE; ++r) {
+        for (int c = 0; c < BOARD_SIZE; ++c) {
+            Square sq = state->board[r][c];
+            if (square_is_occupied(sq)) {
+                len += (size_t)snprintf(buf + len, size - len, "%c%c ", pieceChars[square_type(sq)],
+                                        square_owner(sq) == PLAYER_WHITE ? 'W' : 'B');
+            } else {
+                len += (size_t)snprintf(buf + len, size - len, "__ ");
+            }
+        }
+        len += (size_t)snprintf(buf + len, size - len, "\n");
+    }
+    return len;
+}
+
+static bool load_text(GameState *state, const char *text, size_t len) {
+    /* fmemopen rejects a zero-length buffer, but an empty save must still fail. */
+    if (len == 0) {
+        return false;
+    }
+    FILE *f = fmemopen((void *)text, len, "r");
+    if (!f) {
+        return false;
+    }
+    ChatLog log;
+    chat_init(&log);
+    bool loaded = load_game_from_stream(state, &log, f);
+    fclose(f);
+    return loaded;
+}
+
+/* Loads `text` over a game in progress; the game must end up either fully loaded or untouched. */
+static bool check_load(const char *name, const char *text, size_t len, const GameState *expected, bool mustLoad) {
+    GameState game;
+    play_opening(&game, 5, 0);
+    GameState before = game;
+
+    bool loaded = load_text(&game, text, len);
+    if ((mustLoad && !loaded) || (loaded && !expected)) {
+        printf("FAIL %s (loaded %d)\n", name, (int)loaded);
+        return false;
+    }
+    const GameState *want = loaded ? expected : &before;
+    bool ok = memcmp(game.board, want->board, sizeof(game.board)) == 0 &&
+              memcmp(game.occupancy, want->occupancy, sizeof(game.occupancy)) == 0 &&
+              memcmp(game.pieces, want->pieces, sizeof(game.pieces)) == 0 &&
+              memcmp(game.pieceSquare, want->pieceSquare, sizeof(game.pieceSquare)) == 0 &&
+              memcmp(game.mobility, want->mobility, sizeof(game.mobility)) == 0 &&
+              memcmp(game.score, want->score, sizeof(game.score)) == 0 && game.hash == want->hash &&
+              game.hash == game_compute_hash(&game) && game.currentPlayer == want->currentPlayer &&
+              game.mode == want->mode && game.isPaused == want->isPaused && game.isGameOver == want->isGameOver;
+    if (!ok) {
+        printf("FAIL %s (loaded %d)\n", name, (int)loaded);
+    }
+    return ok;
+}
+
+int main(void) {
+    GameState saved;
+    play_opening(&saved, 8, 3);
+    char text[1024];
+    size_t len = format_save(&saved, text, sizeof(text));
+    unsigned int failures = 0;
+
+    failures += !check_load("valid save", text, len, &saved, true);
+
+    /* Every truncation either fails cleanly or, past the last token, loads the whole save. */
+    for (size_t cut = 0; cut < len; ++cut) {
+        char name[48];
+        snprintf(name, sizeof(name), "truncated at %zu", cut);
+        failures += !check_load(name, text, cut, &saved, false);
+    }
+
+    /* A good board after each bad header, so only the header can be the reason to fail. */
+    static const char *const badHeaders[] = {
+        "CHESS_SAVE_V2\n1 0 0 0 0 0\n",
+        "CHESS_SAVE_V1\n1 0 0 0\n",
+        "CHESS_SAVE_V1\n7 0 0 0 0 0\n",
+        "CHESS_SAVE_V1\n1 2 0 0 0 0\n",
+        "CHESS_SAVE_V1\n1 0 -1 0 0 0\n",
+        "CHESS_SAVE_V1\n1 0 0 5 0 0\n",
+    };
+    const char *board = strchr(strchr(text, '\n') + 1, '\n') + 1;
+    for (size_t i = 0; i < sizeof(badHeaders) / sizeof(badHeaders[0]); ++i) {
+        char corrupt[1024];
+        int corruptLen = snprintf(corrupt, sizeof(corrupt), "%s%s", badHeaders[i], board);
+        failures += !check_load(badHeaders[i], corrupt, (size_t)corruptLen, NULL, false);
+    }
+
+    /* Bad squares late in the board, after the earlier ones would already have been written. */
+    char corrupt[1024];
+    memcpy(corrupt, text, len);
+    memcpy(corrupt + len - 4, "XW ", 3);
+    failures += !check_load("unknown piece", corrupt, len, NULL, false);
+    memcpy(corrupt + len - 4, "RX ", 3);
+    failures += !check_load("unknown owner", corrupt, len, NULL, false);
+    /* Two white rooks: every token parses, so only game_sync_board can reject it. */
+    memcpy(corrupt, text, len);
+    memcpy(corrupt + len - 4, "RW ", 3);
+    memcpy(corrupt + len - 7, "RW ", 3);
+    failures += !check_load("duplicate piece", corrupt, len, NULL, false);
+
+    if (failures) {
+        printf("%u failures\n", failures);
+        return 1;
+    }
+    printf("save/load: all checks passed\n");
+    return 0;
+}
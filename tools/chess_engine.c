@@ -0,0 +1,318 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include "ai.h"
+#include "file_io.h"
+
+#include <pthread.h>
+#include <stdarg.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define ENGINE_NAME "chess_engine"
+#define ENGINE_LINE_SIZE 4096
+#define ENGINE_MOVE_TEXT 5
+
+/*
+ * Line protocol on stdin/stdout, modelled on UCI:
+ *
+ *   uci | isready | newgame | quit
+ *   position (startpos | file <path> | save) [moves <move>...]
+ *   go [depth N] [nodes N] [movetime MS] [softtime MS] [infinite]
+ *   stop
+ *
+ * `position save` reads the text of a save file from the following lines.
+ * Moves are written from-to by file and rank, e.g. "c2d3": files a-h are
+ * columns 0-7 and rank 1 is the bottom row, where WHITE starts. `go`
+ * searches on a thread of its own so `stop` is still read; it prints an
+ * "info" line per finished iteration and ends with "bestmove <move>", or
+ * "bestmove none" when the side to move is stuck. After `go infinite` the
+ * bestmove is held back until `stop` or `quit`, as in UCI, even if the
+ * search itself has finished. Errors are reported as
+ * "info string ..." and the command is ignored. Without a depth or node cap
+ * `go` uses the AI's default move time.
+ */
+typedef struct {
+    GameState position;
+    GameState searchRoot;
+    AiSearchLimits limits;
+    atomic_bool stop;
+    pthread_mutex_t stopLock;
+    pthread_cond_t stopSignal;
+    bool infinite;
+    pthread_t searchThread;
+    bool searching;
+} Engine;
+
+static pthread_mutex_t outputLock = PTHREAD_MUTEX_INITIALIZER;
+
+/* The search thread and the command loop both write, so whole lines go out under a lock. */
+static void send_line(const char *format, ...) {
+    va_list args;
+    va_start(args, format);
+    pthread_mutex_lock(&outputLock);
+    vprintf(format, args);
+    putchar('\n');
+    fflush(stdout);
+    pthread_mutex_unlock(&outputLock);
+    va_end(args);
+}
+
+static void format_move(Move move, char *out) {
+    out[0] = (char)('a' + move.from.col);
+    out[1] = (char)('1' + (BOARD_SIZE - 1 - move.from.row));
+    out[2] = (char)('a' + move.to.col);
+    out[3] = (char)('1' + (BOARD_SIZE - 1 - move.to.row));
+    out[4] = '\0';
+}
+
+static bool parse_square(const char *text, Position *out) {
+    int col = text[0] - 'a';
+    int rank = text[1] - '1';
+    if (col < 0 || col >= BOARD_SIZE || rank < 0 || rank >= BOARD_SIZE) {
+        return false;
+    }
+    out->row = BOARD_SIZE - 1 - rank;
+    out->col = col;
+    return true;
+}
+
+static bool parse_move(const char *text, Move *out) {
+    return strlen(text) == ENGINE_MOVE_TEXT - 1 && parse_square(text, &out->from) && parse_square(text + 2, &out->to);
+}
+
+static void send_info(const AiSearchInfo *info, void *userData) {
+    (void)userData;
+    char pv[AI_MAX_DEPTH * ENGINE_MOVE_TEXT + 1];
+    size_t used = 0;
+    for (size_t i = 0; i < info->pvLength; ++i) {
+        char move[ENGINE_MOVE_TEXT];
+        format_move(info->pv[i], move);
+        used += (size_t)snprintf(pv + used, sizeof(pv) - used, "%s%s", i > 0 ? " " : "", move);
+    }
+    pv[used] = '\0';
+
+    unsigned long long elapsedUs = info->elapsedUs > 0 ? info->elapsedUs : 1;
+    unsigned long long nps = (unsigned long long)info->nodes * 1000000ULL / elapsedUs;
+    send_line("info depth %d score cp %d nodes %lu nps %llu time %llu pv %s",
+              info->depth, info->score, info->nodes, nps, info->elapsedUs / 1000ULL, pv);
+}
+
+static void *search_main(void *arg) {
+    Engine *engine = arg;
+    Move move;
+    char text[ENGINE_MOVE_TEXT] = "none";
+    if (ai_pick_move(&engine->searchRoot, &engine->limits, &move)) {
+        format_move(move, text);
+    }
+    if (engine->infinite) {
+        pthread_mutex_lock(&engine->stopLock);
+        while (!atomic_load(&engine->stop)) {
+            pthread_cond_wait(&engine->stopSignal, &engine->stopLock);
+        }
+        pthread_mutex_unlock(&engine->stopLock);
+    }
+    send_line("bestmove %s", text);
+    return NULL;
+}
+
+static void finish_search(Engine *engine, bool interrupt) {
+    if (!engine->searching) {
+        return;
+    }
+    if (interrupt) {
+        pthread_mutex_lock(&engine->stopLock);
+        atomic_store(&engine->stop, true);
+        pthread_cond_signal(&engine->stopSignal);
+        pthread_mutex_unlock(&engine->stopLock);
+    }
+    pthread_join(engine->searchThread, NULL);
+    engine->searching = false;
+}
+
+static void start_search(Engine *engine, char *args) {
+    AiSearchLimits limits;
+    ai_default_limits(&limits);
+    bool timed = false;
+    bool infinite = false;
+    char *save = NULL;
+    for (char *token = strtok_r(args, " \t", &save); token; token = strtok_r(NULL, " \t", &save)) {
+        if (strcmp(token, "infinite") == 0) {
+            limits.hardTimeMs = 0;
+            timed = true;
+            infinite = true;
+            continue;
+        }
+        char *value = strtok_r(NULL, " \t", &save);
+        if (!value) {
+            send_line("info string missing value for %s", token);
+            return;
+        }
+        if (strcmp(token, "depth") == 0) {
+            limits.maxDepth = atoi(value);
+        } else if (strcmp(token, "nodes") == 0) {
+            limits.maxNodes = strtoul(value, NULL, 10);
+        } else if (strcmp(token, "movetime") == 0) {
+            limits.hardTimeMs = (unsigned int)strtoul(value, NULL, 10);
+            timed = true;
+        } else if (strcmp(token, "softtime") == 0) {
+            limits.softTimeMs = (unsigned int)strtoul(value, NULL, 10);
+        } else {
+            send_line("info string unknown go option %s", token);
+            return;
+        }
+    }
+    /* A depth or node cap without a move time means "search to it", as in UCI. */
+    if (!timed && (limits.maxDepth > 0 || limits.maxNodes > 0)) {
+        limits.hardTimeMs = 0;
+    }
+
+    finish_search(engine, true);
+    engine->searchRoot = engine->position;
+    engine->limits = limits;
+    engine->infinite = infinite;
+    engine->limits.stop = &engine->stop;
+    engine->limits.onInfo = send_info;
+    engine->limits.infoUserData = engine;
+    atomic_store(&engine->stop, false);
+    if (pthread_create(&engine->searchThread, NULL, search_main, engine) != 0) {
+        send_line("info string cannot start search thread");
+        return;
+    }
+    engine->searching = true;
+}
+
+static bool set_position(Engine *engine, char *args) {
+    char *save = NULL;
+    char *token = strtok_r(args, " \t", &save);
+    if (!token) {
+        return false;
+    }
+
+    GameState state;
+    ChatLog log;
+    chat_init(&log);
+    if (strcmp(token, "startpos") == 0) {
+        game_init(&state, MODE_NONE);
+    } else if (strcmp(token, "file") == 0) {
+        const char *path = strtok_r(NULL, " \t", &save);
+        if (!path || !load_game_from_path(&state, &log, path)) {
+            return false;
+        }
+    } else if (strcmp(token, "save") == 0) {
+        if (!load_game_from_stream(&state, &log, stdin)) {
+            return false;
+        }
+    } else {
+        return false;
+    }
+    state.isPaused = false;
+
+    token = strtok_r(NULL, " \t", &save);
+    if (token) {
+        if (strcmp(token, "moves") != 0) {
+            return false;
+        }
+        while ((token = strtok_r(NULL, " \t", &save)) != NULL) {
+            Move move;
+            MoveUndo undo;
+            if (!parse_move(token, &move) || !game_make_move(&state, move, &undo)) {
+                send_line("info string illegal move %s", token);
+                return false;
+            }
+        }
+    }
+    engine->position = state;
+    return true;
+}
+
+static bool init_ai(const AiConfig *config) {
+    if (!ai_init(config)) {
+        send_line("info string some AI tables could not be loaded");
+        return false;
+    }
+    return true;
+}
+
+static void usage(const char *program) {
+    fprintf(stderr, "usage: %s [--threads N] [--hash MB] [--tablebase PATH] [--solution PATH] [--mcts]\n", program);
+}
+
+int main(int argc, char **argv) {
+    AiConfig config;
+    ai_default_config(&config);
+    for (int i = 1; i < argc; ++i) {
+        bool hasValue = i + 1 < argc;
+        if (strcmp(argv[i], "--mcts") == 0) {
+            config.engine = AI_ENGINE_MCTS;
+        } else if (hasValue && strcmp(argv[i], "--threads") == 0) {
+            config.threads = atoi(argv[++i]);
+        } else if (hasValue && strcmp(argv[i], "--hash") == 0) {
+            config.hashSizeMb = strtoul(argv[++i], NULL, 10);
+        } else if (hasValue && strcmp(argv[i], "--tablebase") == 0) {
+            config.tablebasePath = argv[++i];
+        } else if (hasValue && strcmp(argv[i], "--solution") == 0) {
+            config.solutionPath = argv[++i];
+        } else {
+            usage(argv[0]);
+            return 1;
+        }
+    }
+
+    Engine engine;
+    memset(&engine, 0, sizeof(engine));
+    atomic_init(&engine.stop, false);
+    pthread_mutex_init(&engine.stopLock, NULL);
+    pthread_cond_init(&engine.stopSignal, NULL);
+    game_init(&engine.position, MODE_NONE);
+    init_ai(&config);
+
+    char line[ENGINE_LINE_SIZE];
+    while (fgets(line, sizeof(line), stdin)) {
+        line[strcspn(line, "\r\n")] = '\0';
+        char *args = line + strspn(line, " \t");
+        char *command = args;
+        args += strcspn(args, " \t");
+        if (*args) {
+            *args++ = '\0';
+        }
+
+        if (*command == '\0') {
+            continue;
+        } else if (strcmp(command, "uci") == 0) {
+            send_line("id name %s", ENGINE_NAME);
+            send_line("uciok");
+        } else if (strcmp(command, "isready") == 0) {
+            send_line("readyok");
+        } else if (strcmp(command, "newgame") == 0 || strcmp(command, "ucinewgame") == 0) {
+            finish_search(&engine, true);
+            game_init(&engine.position, MODE_NONE);
+            init_ai(&config);
+        } else if (strcmp(command, "position") == 0) {
+            finish_search(&engine, true);
+            if (!set_position(&engine, args)) {
+                send_line("info string bad position command");
+            }
+        } else if (strcmp(command, "go") == 0) {
+            start_search(&engine, args);
+        } else if (strcmp(command, "stop") == 0) {
+            finish_search(&engine, true);
+        } else if (strcmp(command, "quit") == 0) {
+            finish_search(&engine, true);
+            break;
+        } else {
+            send_line("info string unknown command %s", command);
+        }
+    }
+
+    /*
+     * At the end of piped input a bounded search is allowed to finish; an
+     * infinite one would wait for a `stop` that can no longer come.
+     */
+    finish_search(&engine, engine.infinite);
+    ai_shutdown();
+    pthread_cond_destroy(&engine.stopSignal);
+    pthread_mutex_destroy(&engine.stopLock);
+    return 0;
+}
@@ -0,0 +1,335 @@
+#include "game_batch.h"
+#include "game_logic.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define BENCH_SEED 20240601u
+#define BENCH_MAX_POSITIONS 4096
+#define BENCH_DEFAULT_ITERATIONS 200
+#define BENCH_CHECK_PLIES 64
+#define BENCH_CHECK_SEED 0xC0FFEEULL
+
+typedef size_t (*MoveGenerator)(const GameState *state, Player player, Move *moves, size_t maxMoves);
+
+/*
+ * A frozen copy of the rules code before the bitboard rewrite: the board
+ * array of unpacked squares that GameState used to be, and the generator
+ * that copied the whole state for every candidate destination and checked
+ * it square by square. It shares nothing with today's game_logic.c, so the
+ * speedup below stays measured against that code however the engine
+ * changes.
+ */
+typedef struct {
+    bool occupied;
+    PieceType type;
+    Player owner;
+} LegacySquare;
+
+typedef struct {
+    LegacySquare board[BOARD_SIZE][BOARD_SIZE];
+    Player currentPlayer;
+    int score[PLAYER_COUNT];
+    GameMode mode;
+    bool isPaused;
+    bool isGameOver;
+} LegacyState;
+
+static bool legacy_is_inside(Position pos) {
+    return pos.row >= 0 && pos.row < BOARD_SIZE && pos.col >= 0 && pos.col < BOARD_SIZE;
+}
+
+static bool legacy_is_valid_move(const LegacyState *state, Position from, Position to) {
+    if (!state || !legacy_is_inside(from) || !legacy_is_inside(to)) {
+        return false;
+    }
+    if (from.row == to.row && from.col == to.col) {
+        return false;
+    }
+
+    const LegacySquare *fromSquare = &state->board[from.row][from.col];
+    if (!fromSquare->occupied) {
+        return false;
+    }
+
+    int dir = (fromSquare->owner == PLAYER_WHITE) ? -1 : 1;
+    if (to.row != from.row + dir) {
+        return false;
+    }
+
+    int colDiff = to.col - from.col;
+    if (colDiff < -1 || colDiff > 1) {
+        return false;
+    }
+
+    const LegacySquare *toSquare = &state->board[to.row][to.col];
+    if (colDiff == 0) {
+        return !toSquare->occupied;
+    }
+    if (!toSquare->occupied) {
+        return true;
+    }
+    return toSquare->owner != fromSquare->owner;
+}
+
+static size_t legacy_list_moves(const LegacyState *state, Player player, Move *moves, size_t maxMoves) {
+    size_t count = 0;
+    int dir = (player == PLAYER_WHITE) ? -1 : 1;
+    for (int row = 0; row < BOARD_SIZE; ++row) {
+        for (int col = 0; col < BOARD_SIZE; ++col) {
+            const LegacySquare *sq = &state->board[row][col];
+            if (!sq->occupied || sq->owner != player) {
+                continue;
+            }
+            Position from = { row, col };
+            for (int deltaCol = -1; deltaCol <= 1; ++deltaCol) {
+                Position to = { row + dir, col + deltaCol };
+                if (!legacy_is_inside(to)) {
+                    continue;
+                }
+                LegacyState temp = *state;
+                if (legacy_is_valid_move(&temp, from, to)) {
+                    if (count < maxMoves) {
+                        moves[count].from = from;
+                        moves[count].to = to;
+                    }
+                    if (++count >= maxMoves) {
+                        return count;
+                    }
+                }
+            }
+        }
+    }
+    return count;
+}
+
+static void legacy_from_state(const GameState *state, LegacyState *out) {
+    for (int row = 0; row < BOARD_SIZE; ++row) {
+        for (int col = 0; col < BOARD_SIZE; ++col) {
+            Square sq = state->board[row][col];
+            out->board[row][col].occupied = square_is_occupied(sq);
+            out->board[row][col].type = square_is_occupied(sq) ? square_type(sq) : PIECE_ROOK;
+            out->board[row][col].owner = square_is_occupied(sq) ? square_owner(sq) : PLAYER_WHITE;
+        }
+    }
+    out->currentPlayer = state->currentPlayer;
+    out->score[PLAYER_WHITE] = state->score[PLAYER_WHITE];
+    out->score[PLAYER_BLACK] = state->score[PLAYER_BLACK];
+    out->mode = state->mode;
+    out->isPaused = state->isPaused;
+    out->isGameOver = state->isGameOver;
+}
+
+static double run_legacy(const LegacyState *positions, size_t positionCount, int iterations, unsigned long *outMoves) {
+    Move moves[MAX_MOVES_PER_TURN];
+    unsigned long total = 0;
+    clock_t start = clock();
+    for (int iter = 0; iter < iterations; ++iter) {
+        for (size_t i = 0; i < positionCount; ++i) {
+            total += legacy_list_moves(&positions[i], positions[i].currentPlayer, moves, MAX_MOVES_PER_TURN);
+        }
+    }
+    clock_t end = clock();
+    *outMoves = total;
+    return (double)(end - start) / CLOCKS_PER_SEC;
+}
+
+static size_t collect_positions(GameState *positions, size_t maxPositions) {
+    size_t count = 0;
+    srand(BENCH_SEED);
+    while (count < maxPositions) {
+        GameState state;
+        game_init(&state, MODE_PVP);
+        while (!state.isGameOver && count < maxPositions) {
+            positions[count++] = state;
+            Move moves[MAX_MOVES_PER_TURN];
+            size_t moveCount = game_list_moves(&state, state.currentPlayer, moves, MAX_MOVES_PER_TURN);
+            if (moveCount == 0) {
+                break;
+            }
+            Move move = moves[(size_t)rand() % moveCount];
+            game_apply_move(&state, move.from, move.to);
+        }
+    }
+    return count;
+}
+
+static double run_generator(MoveGenerator generator, const GameState *positions, size_t positionCount, int iterations, unsigned long *outMoves) {
+    Move moves[MAX_MOVES_PER_TURN];
+    unsigned long total = 0;
+    clock_t start = clock();
+    for (int iter = 0; iter < iterations; ++iter) {
+        for (size_t i = 0; i < positionCount; ++i) {
+            total += generator(&positions[i], positions[i].currentPlayer, moves, MAX_MOVES_PER_TURN);
+        }
+    }
+    clock_t end = clock();
+    *outMoves = total;
+    return (double)(end - start) / CLOCKS_PER_SEC;
+}
+
+static bool load_batch(GameBatch *batch, GameBatchKernel kernel, const GameState *positions, size_t positionCount) {
+    if (!game_batch_init(batch, positionCount)) {
+        return false;
+    }
+    game_batch_set_kernel(batch, kernel);
+    for (size_t i = 0; i < positionCount; ++i) {
+        game_batch_set(batch, i, &positions[i]);
+    }
+    game_batch_generate(batch);
+    return true;
+}
+
+/* The same positions as one batch: a single generate pass counts every game's moves. */
+static double run_batch(GameBatchKernel kernel, const GameState *positions, size_t positionCount, int iterations, unsigned long *outMoves) {
+    GameBatch batch;
+    *outMoves = 0;
+    if (!load_batch(&batch, kernel, positions, positionCount)) {
+        return 0.0;
+    }
+    unsigned long total = 0;
+    clock_t start = clock();
+    for (int iter = 0; iter < iterations; ++iter) {
+        game_batch_generate(&batch);
+        for (size_t i = 0; i < positionCount; ++i) {
+            total += game_batch_move_count(&batch, i);
+        }
+    }
+    clock_t end = clock();
+    game_batch_free(&batch);
+    *outMoves = total;
+    return (double)(end - start) / CLOCKS_PER_SEC;
+}
+
+/* Bitboards, targets and flags of two batches that should be in the same state. */
+static bool batches_equal(const GameBatch *a, const GameBatch *b) {
+    size_t words = a->count * sizeof(Bitboard);
+    bool same = a->count == b->count && memcmp(a->currentPlayer, b->currentPlayer, a->count) == 0 &&
+                memcmp(a->isGameOver, b->isGameOver, a->count) == 0;
+    for (int p = 0; same && p < PLAYER_COUNT; ++p) {
+        same = memcmp(a->occupancy[p], b->occupancy[p], words) == 0;
+    }
+    for (int d = 0; same && d < 3; ++d) {
+        same = memcmp(a->targets[d], b->targets[d], words) == 0;
+    }
+    return same;
+}
+
+/* The batch's moves and game-over flag for game `index` against game_list_moves on the same position. */
+static bool game_matches(const GameBatch *batch, size_t index) {
+    GameState state;
+    Move expected[MAX_MOVES_PER_TURN];
+    Move moves[MAX_MOVES_PER_TURN];
+    game_batch_get(batch, index, &state);
+    size_t expectedCount = game_list_moves(&state, state.currentPlayer, expected, MAX_MOVES_PER_TURN);
+    size_t count = game_batch_list_moves(batch, index, moves, MAX_MOVES_PER_TURN);
+    if (batch->isGameOver[index]) {
+        return count == 0 && expectedCount == 0;
+    }
+    return count == expectedCount && expectedCount > 0 && memcmp(moves, expected, count * sizeof(Move)) == 0;
+}
+
+/*
+ * Differential check: every kernel the CPU supports plays the same random
+ * games in lockstep with the scalar kernel. After each ply the whole batch
+ * must be bit-identical to the scalar one, and every game's moves must
+ * equal game_list_moves. The game count is odd so the SIMD kernels also
+ * run their scalar tails.
+ */
+static unsigned long check_kernels(const GameState *positions, size_t positionCount) {
+    size_t games = (positionCount % 2 == 0 && positionCount > 1) ? positionCount - 1 : positionCount;
+    unsigned long mismatches = 0;
+    for (int k = 0; k < GAME_BATCH_KERNEL_COUNT; ++k) {
+        GameBatchKernel kernel = (GameBatchKernel)k;
+        if (!game_batch_kernel_supported(kernel)) {
+            printf("check %-6s skipped (not supported by this CPU)\n", game_batch_kernel_name(kernel));
+            continue;
+        }
+        GameBatch reference;
+        GameBatch batch;
+        if (!load_batch(&reference, GAME_BATCH_SCALAR, positions, games)) {
+            return mismatches + 1;
+        }
+        if (!load_batch(&batch, kernel, positions, games)) {
+            game_batch_free(&reference);
+            return mismatches + 1;
+        }
+        uint64_t referenceRng = BENCH_CHECK_SEED;
+        uint64_t rng = BENCH_CHECK_SEED;
+        unsigned long kernelMismatches = 0;
+        for (int ply = 0; ply <= BENCH_CHECK_PLIES; ++ply) {
+            if (!batches_equal(&reference, &batch)) {
+                ++kernelMismatches;
+            }
+            for (size_t i = 0; i < games; ++i) {
+                kernelMismatches += !game_matches(&batch, i);
+            }
+            game_batch_play_random(&reference, &referenceRng);
+            game_batch_play_random(&batch, &rng);
+        }
+        printf("check %-6s %zu games x %d plies: %lu mismatches\n",
+               game_batch_kernel_name(kernel), games, BENCH_CHECK_PLIES, kernelMismatches);
+        mismatches += kernelMismatches;
+        game_batch_free(&reference);
+        game_batch_free(&batch);
+    }
+    return mismatches;
+}
+
+static void report(const char *label, unsigned long moves, double seconds) {
+    double rate = (seconds > 0.0) ? (double)moves / seconds : 0.0;
+    printf("%-16s %12lu moves  %8.3f s  %14.0f moves/s\n", label, moves, seconds, rate);
+}
+
+int main(int argc, char **argv) {
+    bool check = argc > 1 && strcmp(argv[1], "--check") == 0;
+    int iterations = (argc > 1 && !check) ? atoi(argv[1]) : BENCH_DEFAULT_ITERATIONS;
+    if (iterations <= 0) {
+        fprintf(stderr, "usage: %s [iterations | --check]\n", argv[0]);
+        return 1;
+    }
+
+    static GameState positions[BENCH_MAX_POSITIONS];
+    size_t positionCount = collect_positions(positions, BENCH_MAX_POSITIONS);
+    if (check) {
+        return check_kernels(positions, positionCount) == 0 ? 0 : 1;
+    }
+    printf("%zu positions x %d iterations\n", positionCount, iterations);
+
+    static LegacyState legacyPositions[BENCH_MAX_POSITIONS];
+    for (size_t i = 0; i < positionCount; ++i) {
+        legacy_from_state(&positions[i], &legacyPositions[i]);
+    }
+
+    unsigned long legacyMoves = 0;
+    unsigned long currentMoves = 0;
+    double legacySeconds = run_legacy(legacyPositions, positionCount, iterations, &legacyMoves);
+    double currentSeconds = run_generator(game_list_moves, positions, positionCount, iterations, &currentMoves);
+
+    report("legacy (copies)", legacyMoves, legacySeconds);
+    report("game_list_moves", currentMoves, currentSeconds);
+    if (legacyMoves != currentMoves) {
+        fprintf(stderr, "move count mismatch: %lu vs %lu\n", legacyMoves, currentMoves);
+        return 1;
+    }
+    for (int k = 0; k < GAME_BATCH_KERNEL_COUNT; ++k) {
+        if (!game_batch_kernel_supported((GameBatchKernel)k)) {
+            continue;
+        }
+        unsigned long batchMoves = 0;
+        double batchSeconds = run_batch((GameBatchKernel)k, positions, positionCount, iterations, &batchMoves);
+        char label[32];
+        snprintf(label, sizeof(label), "batch %s", game_batch_kernel_name((GameBatchKernel)k));
+        report(label, batchMoves, batchSeconds);
+        if (batchMoves != currentMoves) {
+            fprintf(stderr, "move count mismatch: %lu vs %lu\n", batchMoves, currentMoves);
+            return 1;
+        }
+    }
+    if (currentSeconds > 0.0) {
+        printf("speedup: %.1fx\n", legacySeconds / currentSeconds);
+    }
+    return 0;
+}
@@ -0,0 +1,237 @@
+#include "game_logic.h"
+#include "file_io.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+typedef struct {
+    bool check;
+    unsigned long mismatches;
+} PerftContext;
+
+/* The rules spelled out on the board array, independent of the engine's tables. */
+static bool reference_is_valid(const GameState *state, Position from, Position to) {
+    if (!game_is_valid_position(from) || !game_is_valid_position(to)) {
+        return false;
+    }
+    Square mover = state->board[from.row][from.col];
+    Square target = state->board[to.row][to.col];
+    int dir = (square_owner(mover) == PLAYER_WHITE) ? -1 : 1;
+    int colDiff = to.col - from.col;
+    if (!square_is_occupied(mover) || to.row != from.row + dir || colDiff < -1 || colDiff > 1) {
+        return false;
+    }
+    if (colDiff == 0) {
+        return !square_is_occupied(target);
+    }
+    return !square_is_occupied(target) || square_owner(target) != square_owner(mover);
+}
+
+/*
+ * Reference generator: checks every forward step of every friendly piece,
+ * in row-major order. Slow but obviously correct, so faster generators are
+ * checked against it.
+ */
+static size_t reference_list_moves(const GameState *state, Player player, Move *moves, size_t maxMoves) {
+    size_t count = 0;
+    int dir = (player == PLAYER_WHITE) ? -1 : 1;
+    for (int row = 0; row < BOARD_SIZE; ++row) {
+        for (int col = 0; col < BOARD_SIZE; ++col) {
+            Square sq = state->board[row][col];
+            if (!square_is_occupied(sq) || square_owner(sq) != player) {
+                continue;
+            }
+            for (int deltaCol = -1; deltaCol <= 1; ++deltaCol) {
+                Position from = { row, col };
+                Position to = { row + dir, col + deltaCol };
+                if (reference_is_valid(state, from, to) && count < maxMoves) {
+                    moves[count].from = from;
+                    moves[count].to = to;
+                    ++count;
+                }
+            }
+        }
+    }
+    return count;
+}
+
+static bool is_capture(const GameState *state, Move move) {
+    Square target = state->board[move.to.row][move.to.col];
+    return square_is_occupied(target) && square_owner(target) != state->currentPlayer;
+}
+
+static bool contains_move(const Move *moves, size_t count, Move move) {
+    for (size_t i = 0; i < count; ++i) {
+        if (memcmp(&moves[i], &move, sizeof(Move)) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/* The generators follow the piece lists rather than the board, so moves are compared as sets. */
+static bool moves_match(const Move *expected, size_t expectedCount, const Move *moves, size_t count) {
+    if (count != expectedCount) {
+        return false;
+    }
+    for (size_t i = 0; i < count; ++i) {
+        if (!contains_move(expected, expectedCount, moves[i])) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/* game_list_captures uses its own order, so compare it as a set. */
+static bool captures_match(const GameState *state, const Move *expected, size_t expectedCount) {
+    Move captures[MAX_MOVES_PER_TURN];
+    size_t count = game_list_captures(state, state->currentPlayer, captures, MAX_MOVES_PER_TURN);
+    size_t expectedCaptures = 0;
+    for (size_t i = 0; i < expectedCount; ++i) {
+        expectedCaptures += is_capture(state, expected[i]);
+    }
+    if (count != expectedCaptures) {
+        return false;
+    }
+    for (size_t i = 0; i < count; ++i) {
+        if (!contains_move(expected, expectedCount, captures[i]) || !is_capture(state, captures[i])) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/* Every piece on the board has its own piece list entry, and every entry points at its piece. */
+static bool piece_lists_match(const GameState *state) {
+    for (int player = 0; player < PLAYER_COUNT; ++player) {
+        int listed = 0;
+        for (int type = 0; type < PIECE_TYPE_COUNT; ++type) {
+            int index = state->pieceSquare[player][type];
+            if (index == PIECE_SQUARE_NONE) {
+                continue;
+            }
+            Square sq = state->board[index / BOARD_SIZE][index % BOARD_SIZE];
+            if (!square_is_occupied(sq) || square_owner(sq) != (Player)player || square_type(sq) != (PieceType)type) {
+                return false;
+            }
+            ++listed;
+        }
+        if (listed != __builtin_popcountll(state->occupancy[player])) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/* game_is_valid_move against the reference for every piece and every square within two rows and columns. */
+static bool validity_matches(const GameState *state) {
+    for (Bitboard pieces = state->occupancy[PLAYER_WHITE] | state->occupancy[PLAYER_BLACK]; pieces; pieces &= pieces - 1) {
+        int index = __builtin_ctzll(pieces);
+        Position from = { index / BOARD_SIZE, index % BOARD_SIZE };
+        for (int dr = -2; dr <= 2; ++dr) {
+            for (int dc = -2; dc <= 2; ++dc) {
+                Position to = { from.row + dr, from.col + dc };
+                if (game_is_valid_move(state, from, to) != reference_is_valid(state, from, to)) {
+                    return false;
+                }
+            }
+        }
+    }
+    return true;
+}
+
+static void check_position(PerftContext *ctx, const GameState *state, const Move *moves, size_t count) {
+    Move expected[MAX_MOVES_PER_TURN];
+    size_t expectedCount = reference_list_moves(state, state->currentPlayer, expected, MAX_MOVES_PER_TURN);
+
+    bool ok = moves_match(expected, expectedCount, moves, count);
+    ok = ok && (game_has_any_moves(state, state->currentPlayer) == (expectedCount > 0));
+    for (int player = 0; ok && player < PLAYER_COUNT; ++player) {
+        Move scratch[MAX_MOVES_PER_TURN];
+        ok = (size_t)state->mobility[player] == reference_list_moves(state, (Player)player, scratch, MAX_MOVES_PER_TURN);
+    }
+    ok = ok && (state->hash == game_compute_hash(state));
+    ok = ok && piece_lists_match(state);
+    ok = ok && validity_matches(state);
+    ok = ok && captures_match(state, expected, expectedCount);
+    if (!ok) {
+        ++ctx->mismatches;
+    }
+}
+
+static unsigned long perft(PerftContext *ctx, GameState *state, int depth) {
+    if (depth == 0) {
+        return 1;
+    }
+
+    Move moves[MAX_MOVES_PER_TURN];
+    size_t count = state->isGameOver ? 0 : game_list_moves(state, state->currentPlayer, moves, MAX_MOVES_PER_TURN);
+    if (ctx->check) {
+        check_position(ctx, state, moves, count);
+    }
+    if (depth == 1 && !ctx->check) {
+        return count;
+    }
+
+    unsigned long nodes = 0;
+    for (size_t i = 0; i < count; ++i) {
+        MoveUndo undo;
+        if (!game_make_move(state, moves[i], &undo)) {
+            ++ctx->mismatches;
+            continue;
+        }
+        nodes += perft(ctx, state, depth - 1);
+        game_unmake_move(state, &undo);
+    }
+    return nodes;
+}
+
+static void usage(const char *program) {
+    fprintf(stderr, "usage: %s [--check] <depth> [save-file]\n", program);
+}
+
+int main(int argc, char **argv) {
+    PerftContext ctx = { false, 0 };
+    int argIndex = 1;
+    if (argIndex < argc && strcmp(argv[argIndex], "--check") == 0) {
+        ctx.check = true;
+        ++argIndex;
+    }
+    if (argIndex >= argc) {
+        usage(argv[0]);
+        return 1;
+    }
+
+    int maxDepth = atoi(argv[argIndex++]);
+    if (maxDepth <= 0) {
+        usage(argv[0]);
+        return 1;
+    }
+
+    GameState state;
+    game_init(&state, MODE_NONE);
+    if (argIndex < argc) {
+        ChatLog log;
+        chat_init(&log);
+        if (!load_game_from_path(&state, &log, argv[argIndex])) {
+            fprintf(stderr, "failed to load %s\n", argv[argIndex]);
+            return 1;
+        }
+    }
+
+    for (int depth = 1; depth <= maxDepth; ++depth) {
+        clock_t start = clock();
+        unsigned long nodes = perft(&ctx, &state, depth);
+        double seconds = (double)(clock() - start) / CLOCKS_PER_SEC;
+        double rate = (seconds > 0.0) ? (double)nodes / seconds : 0.0;
+        printf("depth %2d  nodes %14lu  time %8.3f s  %14.0f nodes/s\n", depth, nodes, seconds, rate);
+    }
+
+    if (ctx.check) {
+        printf("check: %lu mismatches\n", ctx.mismatches);
+        return ctx.mismatches == 0 ? 0 : 2;
+    }
+    return 0;
+}
@@ -0,0 +1,87 @@
+#include "ai.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#define BENCH_SEED 20240601u
+#define BENCH_POSITIONS 32
+#define BENCH_PLY_STRIDE 3
+#define BENCH_DEFAULT_DEPTH 7
+
+/* Positions spread over seeded random games, skipping the near-empty openings. */
+static size_t collect_positions(GameState *positions, size_t maxPositions) {
+    size_t count = 0;
+    srand(BENCH_SEED);
+    while (count < maxPositions) {
+        GameState state;
+        game_init(&state, MODE_PVP);
+        for (int ply = 0; !state.isGameOver && count < maxPositions; ++ply) {
+            if (ply >= 4 && ply % BENCH_PLY_STRIDE == 0) {
+                positions[count++] = state;
+            }
+            Move moves[MAX_MOVES_PER_TURN];
+            size_t moveCount = game_list_moves(&state, state.currentPlayer, moves, MAX_MOVES_PER_TURN);
+            if (moveCount == 0) {
+                break;
+            }
+            Move move = moves[(size_t)rand() % moveCount];
+            game_apply_move(&state, move.from, move.to);
+        }
+    }
+    return count;
+}
+
+/* Fixed-depth searches with a fresh hash table per position. */
+static double run_search(bool orderMoves, int depth, const GameState *positions, size_t positionCount, unsigned long *outNodes) {
+    AiConfig config;
+    ai_default_config(&config);
+    config.orderMoves = orderMoves;
+
+    AiSearchLimits limits = { 0 };
+    limits.maxDepth = depth;
+
+    unsigned long total = 0;
+    clock_t start = clock();
+    for (size_t i = 0; i < positionCount; ++i) {
+        ai_init(&config);
+        Move move;
+        ai_pick_move(&positions[i], &limits, &move);
+        AiSearchStats stats;
+        ai_last_search_stats(&stats);
+        total += stats.nodes;
+    }
+    clock_t end = clock();
+    ai_shutdown();
+    *outNodes = total;
+    return (double)(end - start) / CLOCKS_PER_SEC;
+}
+
+static void report(const char *label, unsigned long nodes, double seconds) {
+    double rate = (seconds > 0.0) ? (double)nodes / seconds : 0.0;
+    printf("%-16s %12lu nodes  %8.3f s  %14.0f nodes/s\n", label, nodes, seconds, rate);
+}
+
+int main(int argc, char **argv) {
+    int depth = (argc > 1) ? atoi(argv[1]) : BENCH_DEFAULT_DEPTH;
+    if (depth <= 0 || depth >= AI_MAX_DEPTH) {
+        fprintf(stderr, "usage: %s [depth]\n", argv[0]);
+        return 1;
+    }
+
+    static GameState positions[BENCH_POSITIONS];
+    size_t positionCount = collect_positions(positions, BENCH_POSITIONS);
+    printf("%zu positions searched to depth %d\n", positionCount, depth);
+
+    unsigned long plainNodes = 0;
+    unsigned long orderedNodes = 0;
+    double plainSeconds = run_search(false, depth, positions, positionCount, &plainNodes);
+    double orderedSeconds = run_search(true, depth, positions, positionCount, &orderedNodes);
+
+    report("hash move only", plainNodes, plainSeconds);
+    report("full ordering", orderedNodes, orderedSeconds);
+    if (plainNodes > 0) {
+        printf("node reduction: %.1f%%\n", 100.0 * (1.0 - (double)orderedNodes / (double)plainNodes));
+    }
+    return 0;
+}
@@ -0,0 +1,262 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include "ai.h"
+
+#include <math.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#define SELFPLAY_DEFAULT_GAMES 100
+#define SELFPLAY_DEFAULT_RANDOM_PLIES 4
+#define SELFPLAY_MAX_JOBS 256
+#define SELFPLAY_SEED 0x5E1F9A7ULL
+
+/* One side of the match: how its engine is built and how long it may think. */
+typedef struct {
+    AiConfig config;
+    AiSearchLimits limits;
+} Contestant;
+
+typedef struct {
+    Contestant contestants[2];
+    int gameCount;
+    int randomPlies;
+
+    pthread_mutex_t lock;
+    int nextGame;
+    int wins;
+    int draws;
+    int losses;
+    long long scoreDiffSum;
+    bool failed;
+} Match;
+
+/* xorshift64*, seeded per game pair so both colours get the same opening. */
+static uint64_t next_random(uint64_t *rng) {
+    *rng ^= *rng >> 12;
+    *rng ^= *rng << 25;
+    *rng ^= *rng >> 27;
+    return *rng * 0x2545F4914F6CDD1DULL;
+}
+
+/*
+ * Plays game `index` and returns the final capture difference from the
+ * point of view of contestant 0, who has WHITE in even games. The first
+ * plies are random, so depth-limited engines do not replay one game.
+ */
+static int play_game(const Match *match, AiInstance *engines[2], int index) {
+    GameState state;
+    game_init(&state, MODE_NONE);
+
+    uint64_t rng = (SELFPLAY_SEED + (uint64_t)(index / 2)) * 0x9E3779B97F4A7C15ULL | 1;
+    for (int ply = 0; ply < match->randomPlies && !state.isGameOver; ++ply) {
+        Move moves[MAX_MOVES_PER_TURN];
+        size_t count = game_list_moves(&state, state.currentPlayer, moves, MAX_MOVES_PER_TURN);
+        if (count == 0) {
+            break;
+        }
+        Move move = moves[next_random(&rng) % count];
+        game_apply_move(&state, move.from, move.to);
+    }
+
+    int whiteEngine = index % 2;
+    while (!state.isGameOver) {
+        int side = (state.currentPlayer == PLAYER_WHITE) ? whiteEngine : 1 - whiteEngine;
+        Move move;
+        if (!ai_instance_pick_move(engines[side], &state, &match->contestants[side].limits, &move) ||
+            !game_apply_move(&state, move.from, move.to)) {
+            break;
+        }
+    }
+
+    Player first = (whiteEngine == 0) ? PLAYER_WHITE : PLAYER_BLACK;
+    return state.score[first] - state.score[game_get_opponent(first)];
+}
+
+/* Each worker owns its game state and one engine per contestant for all its games. */
+static void *worker_main(void *arg) {
+    Match *match = arg;
+    AiInstance *engines[2] = { ai_create(), ai_create() };
+    bool ready = engines[0] && engines[1];
+    for (int i = 0; ready && i < 2; ++i) {
+        ready = ai_instance_init(engines[i], &match->contestants[i].config);
+    }
+
+    for (;;) {
+        pthread_mutex_lock(&match->lock);
+        int index = match->nextGame;
+        if (!ready) {
+            match->failed = true;
+        }
+        if (match->failed || index >= match->gameCount) {
+            pthread_mutex_unlock(&match->lock);
+            break;
+        }
+        ++match->nextGame;
+        pthread_mutex_unlock(&match->lock);
+
+        int diff = play_game(match, engines, index);
+
+        pthread_mutex_lock(&match->lock);
+        match->scoreDiffSum += diff;
+        if (diff > 0) {
+            ++match->wins;
+        } else if (diff < 0) {
+            ++match->losses;
+        } else {
+            ++match->draws;
+        }
+        pthread_mutex_unlock(&match->lock);
+    }
+
+    ai_destroy(engines[0]);
+    ai_destroy(engines[1]);
+    return NULL;
+}
+
+static double elo_from_score(double score) {
+    return -400.0 * log10(1.0 / score - 1.0);
+}
+
+/* Logistic Elo difference with a 95% interval from the spread of per-game scores. */
+static void report(const Match *match, int games, double seconds) {
+    double score = (match->wins + 0.5 * match->draws) / games;
+    double variance = (match->wins * (1.0 - score) * (1.0 - score) +
+                       match->draws * (0.5 - score) * (0.5 - score) +
+                       match->losses * score * score) / games;
+    double margin = 1.96 * sqrt(variance / games);
+
+    printf("games %d  A wins %d  draws %d  B wins %d\n", games, match->wins, match->draws, match->losses);
+    printf("score %.1f%%  mean capture difference %+.3f (A - B)\n", 100.0 * score, (double)match->scoreDiffSum / games);
+    if (score <= 0.0 || score >= 1.0) {
+        printf("elo   %s (no mixed results to estimate from)\n", score <= 0.0 ? "-inf" : "+inf");
+    } else {
+        double low = (score - margin > 0.0) ? elo_from_score(score - margin) : -INFINITY;
+        double high = (score + margin < 1.0) ? elo_from_score(score + margin) : INFINITY;
+        printf("elo   %+.1f  (95%% interval %+.1f .. %+.1f)\n", elo_from_score(score), low, high);
+    }
+    printf("time  %.2f s  %.2f games/s\n", seconds, seconds > 0.0 ? games / seconds : 0.0);
+}
+
+/* "key=value,key=value" with keys engine (ab|mcts), depth, nodes, time, soft, threads, hash, tablebase. */
+static bool parse_contestant(char *spec, Contestant *out) {
+    char *save = NULL;
+    for (char *item = strtok_r(spec, ",", &save); item; item = strtok_r(NULL, ",", &save)) {
+        char *value = strchr(item, '=');
+        if (!value) {
+            return false;
+        }
+        *value++ = '\0';
+        if (strcmp(item, "engine") == 0) {
+            if (strcmp(value, "ab") == 0) {
+                out->config.engine = AI_ENGINE_ALPHA_BETA;
+            } else if (strcmp(value, "mcts") == 0) {
+                out->config.engine = AI_ENGINE_MCTS;
+            } else {
+                return false;
+            }
+        } else if (strcmp(item, "depth") == 0) {
+            out->limits.maxDepth = atoi(value);
+        } else if (strcmp(item, "nodes") == 0) {
+            out->limits.maxNodes = strtoul(value, NULL, 10);
+        } else if (strcmp(item, "time") == 0) {
+            out->limits.hardTimeMs = (unsigned int)strtoul(value, NULL, 10);
+        } else if (strcmp(item, "soft") == 0) {
+            out->limits.softTimeMs = (unsigned int)strtoul(value, NULL, 10);
+        } else if (strcmp(item, "threads") == 0) {
+            out->config.threads = atoi(value);
+        } else if (strcmp(item, "hash") == 0) {
+            out->config.hashSizeMb = strtoul(value, NULL, 10);
+        } else if (strcmp(item, "tablebase") == 0) {
+            out->config.tablebasePath = value;
+        } else {
+            return false;
+        }
+    }
+    return true;
+}
+
+static void usage(const char *program) {
+    fprintf(stderr,
+            "usage: %s [--games M] [--jobs N] [--random-plies K] [-a SPEC] [-b SPEC]\n"
+            "  SPEC is key=value,... with engine=ab|mcts, depth, nodes, time (ms), soft (ms), threads, hash (MB), tablebase\n",
+            program);
+}
+
+int main(int argc, char **argv) {
+    Match match;
+    memset(&match, 0, sizeof(match));
+    match.gameCount = SELFPLAY_DEFAULT_GAMES;
+    match.randomPlies = SELFPLAY_DEFAULT_RANDOM_PLIES;
+    for (int i = 0; i < 2; ++i) {
+        ai_default_config(&match.contestants[i].config);
+        ai_default_limits(&match.contestants[i].limits);
+    }
+    long jobs = sysconf(_SC_NPROCESSORS_ONLN);
+
+    for (int i = 1; i < argc; ++i) {
+        bool hasValue = i + 1 < argc;
+        bool ok = hasValue;
+        if (ok && strcmp(argv[i], "--games") == 0) {
+            match.gameCount = atoi(argv[++i]);
+        } else if (ok && strcmp(argv[i], "--jobs") == 0) {
+            jobs = atol(argv[++i]);
+        } else if (ok && strcmp(argv[i], "--random-plies") == 0) {
+            match.randomPlies = atoi(argv[++i]);
+        } else if (ok && strcmp(argv[i], "-a") == 0) {
+            ok = parse_contestant(argv[++i], &match.contestants[0]);
+        } else if (ok && strcmp(argv[i], "-b") == 0) {
+            ok = parse_contestant(argv[++i], &match.contestants[1]);
+        } else {
+            ok = false;
+        }
+        if (!ok) {
+            usage(argv[0]);
+            return 1;
+        }
+    }
+    if (match.gameCount <= 0 || match.randomPlies < 0) {
+        usage(argv[0]);
+        return 1;
+    }
+    if (jobs < 1) {
+        jobs = 1;
+    } else if (jobs > SELFPLAY_MAX_JOBS) {
+        jobs = SELFPLAY_MAX_JOBS;
+    }
+    if (jobs > match.gameCount) {
+        jobs = match.gameCount;
+    }
+
+    pthread_mutex_init(&match.lock, NULL);
+    pthread_t workers[SELFPLAY_MAX_JOBS];
+    struct timespec start;
+    struct timespec end;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    int started = 0;
+    for (; started < jobs; ++started) {
+        if (pthread_create(&workers[started], NULL, worker_main, &match) != 0) {
+            break;
+        }
+    }
+    for (int i = 0; i < started; ++i) {
+        pthread_join(workers[i], NULL);
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    pthread_mutex_destroy(&match.lock);
+
+    int played = match.wins + match.draws + match.losses;
+    if (match.failed || started == 0 || played == 0) {
+        fprintf(stderr, "could not set up the engines (hash table or tablebase)\n");
+        return 1;
+    }
+
+    double seconds = (double)(end.tv_sec - start.tv_sec) + (double)(end.tv_nsec - start.tv_nsec) / 1e9;
+    printf("%d games on %d threads\n", played, started);
+    report(&match, played, seconds);
+    return 0;
+}
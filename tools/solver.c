@@ -0,0 +1,176 @@
+#include "game_logic.h"
+#include "file_io.h"
+#include "solution_table.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define SOLVER_DEFAULT_MAX_POSITIONS 2000000UL
+
+/*
+ * Moves only go forward, so the game graph is acyclic and a memoised
+ * depth-first search visits each reachable position once, finishing its
+ * children before the position itself (a retrograde order). The in-memory
+ * table is kept at most half full and compacted before it is written.
+ */
+typedef struct {
+    SolutionSlot *slots;
+    uint64_t slotMask;
+    uint64_t entryCount;
+    uint64_t maxEntries;
+    bool overflow;
+} Solver;
+
+static int solve(Solver *solver, GameState *state) {
+    SolutionKey key;
+    solution_key_from_state(state, &key);
+    SolutionSlot *slot = solution_slot_find(solver->slots, solver->slotMask, &key);
+    if (slot->occupied) {
+        return slot->value;
+    }
+
+    Move moves[MAX_MOVES_PER_TURN];
+    size_t count = game_list_moves(state, state->currentPlayer, moves, MAX_MOVES_PER_TURN);
+    int best = 0;
+    for (size_t i = 0; i < count && !solver->overflow; ++i) {
+        MoveUndo undo;
+        if (!game_make_move(state, moves[i], &undo)) {
+            continue;
+        }
+        int gain = (square_is_occupied(undo.captured) ? 1 : 0) - solve(solver, state);
+        game_unmake_move(state, &undo);
+        if (i == 0 || gain > best) {
+            best = gain;
+        }
+    }
+    if (solver->overflow) {
+        return 0;
+    }
+    if (solver->entryCount >= solver->maxEntries) {
+        solver->overflow = true;
+        return 0;
+    }
+
+    /* The recursion may have filled slots since the lookup above. */
+    slot = solution_slot_find(solver->slots, solver->slotMask, &key);
+    slot->occupied = key.occupied;
+    slot->whiteMask = key.whiteMask;
+    slot->sideToMove = key.sideToMove;
+    slot->value = (int8_t)best;
+    ++solver->entryCount;
+    return best;
+}
+
+static uint64_t table_size_for(uint64_t entries, uint64_t loadDivisor) {
+    uint64_t size = 1;
+    while (size < entries * loadDivisor) {
+        size *= 2;
+    }
+    return size;
+}
+
+static bool write_table(const Solver *solver, const char *path) {
+    /* Rehash into a table sized for the final entry count (at most 75% full). */
+    uint64_t slotCount = table_size_for(solver->entryCount + solver->entryCount / 3, 1);
+    SolutionSlot *compact = calloc(slotCount, sizeof(SolutionSlot));
+    if (!compact) {
+        return false;
+    }
+    for (uint64_t i = 0; i <= solver->slotMask; ++i) {
+        const SolutionSlot *src = &solver->slots[i];
+        if (src->occupied) {
+            SolutionKey key = { src->occupied, src->whiteMask, src->sideToMove };
+            *solution_slot_find(compact, slotCount - 1, &key) = *src;
+        }
+    }
+
+    SolutionTableHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, SOLUTION_TABLE_MAGIC, sizeof(header.magic));
+    header.version = SOLUTION_TABLE_VERSION;
+    header.slotSize = sizeof(SolutionSlot);
+    header.slotCount = slotCount;
+    header.entryCount = solver->entryCount;
+
+    FILE *f = fopen(path, "wb");
+    bool ok = f != NULL;
+    ok = ok && fwrite(&header, sizeof(header), 1, f) == 1;
+    ok = ok && fwrite(compact, sizeof(SolutionSlot), slotCount, f) == slotCount;
+    if (f && fclose(f) != 0) {
+        ok = false;
+    }
+    free(compact);
+    return ok;
+}
+
+static void usage(const char *program) {
+    fprintf(stderr, "usage: %s [--max-positions N] <output-file> [save-file]\n", program);
+}
+
+int main(int argc, char **argv) {
+    unsigned long maxPositions = SOLVER_DEFAULT_MAX_POSITIONS;
+    int argIndex = 1;
+    if (argIndex + 1 < argc && strcmp(argv[argIndex], "--max-positions") == 0) {
+        maxPositions = strtoul(argv[argIndex + 1], NULL, 10);
+        argIndex += 2;
+    }
+    if (argIndex >= argc || maxPositions == 0) {
+        usage(argv[0]);
+        return 1;
+    }
+    const char *outputPath = argv[argIndex++];
+
+    GameState state;
+    game_init(&state, MODE_NONE);
+    if (argIndex < argc) {
+        ChatLog log;
+        chat_init(&log);
+        if (!load_game_from_path(&state, &log, argv[argIndex])) {
+            fprintf(stderr, "failed to load %s\n", argv[argIndex]);
+            return 1;
+        }
+    }
+
+    SolutionKey rootKey;
+    if (!solution_key_from_state(&state, &rootKey)) {
+        fprintf(stderr, "positions with more than %d pieces are not supported\n", SOLUTION_MAX_PIECES);
+        return 1;
+    }
+
+    Solver solver;
+    memset(&solver, 0, sizeof(solver));
+    solver.maxEntries = maxPositions;
+    uint64_t slotCount = table_size_for(maxPositions, 2);
+    solver.slots = calloc(slotCount, sizeof(SolutionSlot));
+    if (!solver.slots) {
+        fprintf(stderr, "cannot allocate %llu slots\n", (unsigned long long)slotCount);
+        return 1;
+    }
+    solver.slotMask = slotCount - 1;
+
+    clock_t start = clock();
+    int value = solve(&solver, &state);
+    double seconds = (double)(clock() - start) / CLOCKS_PER_SEC;
+
+    if (solver.overflow) {
+        fprintf(stderr, "more than %lu positions are reachable; raise --max-positions or solve from a later save\n", maxPositions);
+        free(solver.slots);
+        return 2;
+    }
+
+    Player mover = state.currentPlayer;
+    int finalDiff = state.score[mover] - state.score[game_get_opponent(mover)] + value;
+    printf("%llu positions solved in %.2f s\n", (unsigned long long)solver.entryCount, seconds);
+    printf("%s to move gains %+d captures under perfect play (final difference %+d)\n",
+           mover == PLAYER_WHITE ? "WHITE" : "BLACK", value, finalDiff);
+
+    bool written = write_table(&solver, outputPath);
+    free(solver.slots);
+    if (!written) {
+        fprintf(stderr, "failed to write %s\n", outputPath);
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,155 @@
+#include "game_logic.h"
+#include "tablebase.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+/*
+ * Fills the tablebase by memoised search over every placement of 1..3
+ * pieces per side (at most TABLEBASE_MAX_PIECES in total). Successors stay
+ * in the same class or, after a capture, drop to a smaller one, so every
+ * lookup lands inside the table being built.
+ */
+typedef struct {
+    uint8_t *data;
+    uint64_t solved;
+} Generator;
+
+static int read_entry(const Generator *gen, uint64_t index) {
+    uint8_t byte = gen->data[index / 2];
+    return (index & 1) ? (byte >> 4) : (byte & 0x0F);
+}
+
+static void write_entry(Generator *gen, uint64_t index, int nibble) {
+    uint8_t *byte = &gen->data[index / 2];
+    if (index & 1) {
+        *byte = (uint8_t)((*byte & 0x0F) | (nibble << 4));
+    } else {
+        *byte = (uint8_t)((*byte & 0xF0) | nibble);
+    }
+}
+
+static int solve(Generator *gen, GameState *state) {
+    uint64_t index;
+    if (!tablebase_entry_index(state->occupancy[PLAYER_WHITE], state->occupancy[PLAYER_BLACK], state->currentPlayer, &index)) {
+        return 0;
+    }
+    int stored = read_entry(gen, index);
+    if (stored != 0) {
+        return stored - TABLEBASE_VALUE_BIAS;
+    }
+
+    Move moves[MAX_MOVES_PER_TURN];
+    size_t count = game_list_moves(state, state->currentPlayer, moves, MAX_MOVES_PER_TURN);
+    int best = 0;
+    bool found = false;
+    for (size_t i = 0; i < count; ++i) {
+        MoveUndo undo;
+        if (!game_make_move(state, moves[i], &undo)) {
+            continue;
+        }
+        int gain = (square_is_occupied(undo.captured) ? 1 : 0) - solve(gen, state);
+        game_unmake_move(state, &undo);
+        if (!found || gain > best) {
+            best = gain;
+            found = true;
+        }
+    }
+
+    write_entry(gen, index, best + TABLEBASE_VALUE_BIAS);
+    ++gen->solved;
+    return best;
+}
+
+static void set_position(GameState *state, Bitboard white, Bitboard black, Player sideToMove) {
+    game_reset(state, MODE_NONE);
+    /* Types never affect the rules, but a side may hold only one piece of each. */
+    int nextType[PLAYER_COUNT] = { PIECE_ROOK, PIECE_ROOK };
+    for (int row = 0; row < BOARD_SIZE; ++row) {
+        for (int col = 0; col < BOARD_SIZE; ++col) {
+            Bitboard bit = (Bitboard)1 << (row * BOARD_SIZE + col);
+            Player owner = (black & bit) ? PLAYER_BLACK : PLAYER_WHITE;
+            state->board[row][col] = ((white | black) & bit) ? square_make(owner, (PieceType)nextType[owner]++) : SQUARE_EMPTY;
+        }
+    }
+    state->currentPlayer = sideToMove;
+    game_sync_board(state);
+    state->isGameOver = !game_has_any_moves(state, sideToMove);
+}
+
+/* Visits every set of `count` more black squares at or after `from` that avoids the white pieces. */
+static void for_each_black_set(Generator *gen, GameState *state, Bitboard white, Bitboard black, int count, int from) {
+    if (count == 0) {
+        for (int side = 0; side < PLAYER_COUNT; ++side) {
+            set_position(state, white, black, (Player)side);
+            solve(gen, state);
+        }
+        return;
+    }
+    for (int sq = from; sq < BOARD_SIZE * BOARD_SIZE; ++sq) {
+        Bitboard bit = (Bitboard)1 << sq;
+        if (!(white & bit)) {
+            for_each_black_set(gen, state, white, black | bit, count - 1, sq + 1);
+        }
+    }
+}
+
+static void for_each_white_set(Generator *gen, GameState *state, Bitboard white, int whiteLeft, int blackCount, int from) {
+    if (whiteLeft == 0) {
+        for_each_black_set(gen, state, white, 0, blackCount, 0);
+        return;
+    }
+    for (int sq = from; sq < BOARD_SIZE * BOARD_SIZE; ++sq) {
+        for_each_white_set(gen, state, white | ((Bitboard)1 << sq), whiteLeft - 1, blackCount, sq + 1);
+    }
+}
+
+int main(int argc, char **argv) {
+    if (argc != 2) {
+        fprintf(stderr, "usage: %s <output-file>\n", argv[0]);
+        return 1;
+    }
+
+    uint64_t entryCount = tablebase_entry_count();
+    size_t dataSize = (size_t)((entryCount + 1) / 2);
+    Generator gen = { calloc(dataSize, 1), 0 };
+    if (!gen.data) {
+        fprintf(stderr, "cannot allocate %zu bytes\n", dataSize);
+        return 1;
+    }
+
+    clock_t start = clock();
+    GameState state;
+    for (int total = 2; total <= TABLEBASE_MAX_PIECES; ++total) {
+        for (int white = 1; white < total; ++white) {
+            for_each_white_set(&gen, &state, 0, white, total - white, 0);
+            printf("%d white + %d black: done (%llu positions so far)\n", white, total - white, (unsigned long long)gen.solved);
+        }
+    }
+    double seconds = (double)(clock() - start) / CLOCKS_PER_SEC;
+
+    TablebaseHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, TABLEBASE_MAGIC, sizeof(header.magic));
+    header.version = TABLEBASE_VERSION;
+    header.maxPieces = TABLEBASE_MAX_PIECES;
+    header.entryCount = entryCount;
+
+    FILE *f = fopen(argv[1], "wb");
+    bool ok = f != NULL;
+    ok = ok && fwrite(&header, sizeof(header), 1, f) == 1;
+    ok = ok && fwrite(gen.data, 1, dataSize, f) == dataSize;
+    if (f && fclose(f) != 0) {
+        ok = false;
+    }
+    free(gen.data);
+    if (!ok) {
+        fprintf(stderr, "failed to write %s\n", argv[1]);
+        return 1;
+    }
+
+    printf("%llu positions in %.2f s, %zu bytes of data\n", (unsigned long long)gen.solved, seconds, dataSize);
+    return 0;
+}